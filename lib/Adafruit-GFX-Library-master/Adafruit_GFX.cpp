@@ -32,12 +32,16 @@ POSSIBILITY OF SUCH DAMAGE.
  */
 
 #include "Adafruit_GFX.h"
+#include "GFXdither.h"
 #include "glcdfont.c"
 #ifdef __AVR__
   #include <avr/pgmspace.h>
 #elif defined(ESP8266) || defined(ESP32)
   #include <pgmspace.h>
 #endif
+#if defined(__SSE2__)
+  #include <emmintrin.h>
+#endif
 
 // Many (but maybe not all) non-AVR board installs define macros
 // for compatibility with existing PROGMEM-reading AVR code.
@@ -66,10 +70,19 @@ POSSIBILITY OF SUCH DAMAGE.
 #define min(a,b) (((a) < (b)) ? (a) : (b))
 #endif
 
+#ifndef max
+#define max(a,b) (((a) > (b)) ? (a) : (b))
+#endif
+
 #ifndef _swap_int16_t
 #define _swap_int16_t(a, b) { int16_t t = a; a = b; b = t; }
 #endif
 
+// Tile size (pixels square) for GFXcanvas8/16 rotateInto()
+#ifndef GFX_ROTATE_BLOCK
+#define GFX_ROTATE_BLOCK 16
+#endif
+
 Adafruit_GFX::Adafruit_GFX(int16_t w, int16_t h):
 WIDTH(w), HEIGHT(h)
 {
@@ -82,6 +95,20 @@ WIDTH(w), HEIGHT(h)
     wrap      = true;
     _cp437    = false;
     gfxFont   = NULL;
+    fontFamily = NULL;
+    fontSource = NULL;
+    measuredSource = NULL;
+    pageBuffer = NULL;
+    boundsMemo.len = boundsMemo.room = 0;
+    boundsMemo.text = NULL;
+    lineCanvas = NULL;
+    lineFont   = NULL;
+    utf8Left  = 0;
+}
+
+Adafruit_GFX::~Adafruit_GFX(void) {
+    if(lineCanvas) delete lineCanvas;
+    free(boundsMemo.text);
 }
 
 // Bresenham's algorithm - thx wikpedia
@@ -457,6 +484,188 @@ void Adafruit_GFX::fillTriangle(int16_t x0, int16_t y0,
     endWrite();
 }
 
+// POLYGON FUNCTIONS -------------------------------------------------------
+
+// Polygons are given as 'n' vertex pairs {x0,y0, x1,y1, ...}, offset by
+// (x,y) and implicitly closed.  As with the bitmap functions, a const
+// array is expected in PROGMEM and a non-const pointer in RAM.
+
+// Read one vertex coordinate from PROGMEM or RAM
+static inline int16_t polyCoord(const int16_t *points, uint16_t i,
+  boolean pgm) {
+    return pgm ? (int16_t)pgm_read_word(&points[i]) : points[i];
+}
+
+void Adafruit_GFX::polygonOutline(int16_t x, int16_t y,
+  const int16_t *points, uint16_t n, uint16_t color, boolean pgm) {
+    if(!n) return;
+    int16_t x0 = x + polyCoord(points, n * 2 - 2, pgm),
+            y0 = y + polyCoord(points, n * 2 - 1, pgm);
+    startWrite();
+    for(uint16_t i=0; i<n; i++) {
+        int16_t x1 = x + polyCoord(points, i * 2    , pgm),
+                y1 = y + polyCoord(points, i * 2 + 1, pgm);
+        writeLine(x0, y0, x1, y1, color);
+        x0 = x1;
+        y0 = y1;
+    }
+    endWrite();
+}
+
+// Draw the outline of a polygon (PROGMEM vertices)
+void Adafruit_GFX::drawPolygon(int16_t x, int16_t y,
+  const int16_t points[], uint16_t n, uint16_t color) {
+    polygonOutline(x, y, points, n, color, true);
+}
+
+// Draw the outline of a polygon (RAM vertices)
+void Adafruit_GFX::drawPolygon(int16_t x, int16_t y,
+  int16_t *points, uint16_t n, uint16_t color) {
+    polygonOutline(x, y, points, n, color, false);
+}
+
+// Polygons with up to this many vertices are filled without malloc()
+#ifndef GFX_POLY_EDGES
+#define GFX_POLY_EDGES 16
+#endif
+
+// One non-horizontal polygon edge in the scan converter
+typedef struct {
+    int32_t xc;    // X crossing at current scanline center, 16.16
+    int32_t dx;    // X step per scanline, 16.16
+    int16_t ytop;  // First scanline crossed
+    int16_t ybot;  // Scanline after the last one crossed
+    int8_t  wind;  // +1 downward edge, -1 upward edge
+} GFXedge;
+
+// Scan-convert a polygon using an edge table sorted by top scanline and
+// an active edge list sorted by X crossing.  Pixels are filled when their
+// center lies inside the polygon, so shapes sharing an edge don't overlap
+// and an axis-aligned rectangle covers the same pixels as fillRect().
+// Each run of inside pixels on a scanline is one writeFastHLine(),
+// clipped to the display.  Edge storage (an edge and a pointer per
+// vertex) is on the stack for up to GFX_POLY_EDGES vertices, else
+// malloc'd per call; nothing is drawn if that fails.
+void Adafruit_GFX::scanPolygon(int16_t x, int16_t y, const int16_t *points,
+  uint16_t n, uint16_t color, uint8_t rule, boolean pgm) {
+
+    if(n < 3) return;
+    GFXedge   edgeBuf[GFX_POLY_EDGES], *activeBuf[GFX_POLY_EDGES];
+    GFXedge  *edge   = edgeBuf;
+    GFXedge **active = activeBuf;
+    if(n > GFX_POLY_EDGES) {
+        edge   = (GFXedge *)malloc(n * sizeof(GFXedge));
+        active = (GFXedge **)malloc(n * sizeof(GFXedge *));
+        if(!edge || !active) {
+            free(edge);
+            free(active);
+            return;
+        }
+    }
+
+    // Build edge table, skipping horizontal edges (they never cross
+    // a scanline center) and sorting by top scanline as we go.
+    uint16_t nEdges = 0;
+    int16_t  ymin   = 0x7FFF, ymax = -0x8000;
+    int16_t  x0 = x + polyCoord(points, n * 2 - 2, pgm),
+             y0 = y + polyCoord(points, n * 2 - 1, pgm);
+    for(uint16_t i=0; i<n; i++) {
+        int16_t x1 = x + polyCoord(points, i * 2    , pgm),
+                y1 = y + polyCoord(points, i * 2 + 1, pgm);
+        if(y0 != y1) {
+            GFXedge e;
+            int16_t xa = x0, ya = y0, xb = x1, yb = y1;
+            e.wind = 1;
+            if(ya > yb) {
+                _swap_int16_t(xa, xb);
+                _swap_int16_t(ya, yb);
+                e.wind = -1;
+            }
+            // An edge over 32767 pixels wide per scanline overflows
+            // 16.16, but then it only crosses one scanline: the step is
+            // only needed (in 64 bits) to find the crossing
+            int64_t dx = (int64_t)(xb - xa) * 0x10000 / (yb - ya);
+            e.ytop = ya;
+            e.ybot = yb;
+            e.dx   = (yb - ya > 1) ? (int32_t)dx : 0;
+            e.xc   = (int32_t)xa * 0x10000 + (int32_t)(dx / 2);
+            if(ya < ymin) ymin = ya;
+            if(yb > ymax) ymax = yb;
+            uint16_t j = nEdges++;
+            for(; j && (edge[j - 1].ytop > e.ytop); j--) edge[j] = edge[j - 1];
+            edge[j] = e;
+        }
+        x0 = x1;
+        y0 = y1;
+    }
+
+    int16_t  yEnd    = min(ymax, _height);
+    uint16_t nActive = 0, next = 0;
+
+    startWrite();
+    for(int16_t sy = max(ymin, (int16_t)0); sy < yEnd; sy++) {
+        // Retire finished edges, advance the rest to this scanline
+        uint16_t k = 0;
+        for(uint16_t i=0; i<nActive; i++) {
+            if(active[i]->ybot > sy) {
+                active[i]->xc += active[i]->dx;
+                active[k++]    = active[i];
+            }
+        }
+        nActive = k;
+        // Add edges starting here (or above, when clipped at the top)
+        while((next < nEdges) && (edge[next].ytop <= sy)) {
+            GFXedge *e = &edge[next++];
+            if(e->ybot <= sy) continue;
+            e->xc  = (int32_t)(e->xc + (int64_t)(sy - e->ytop) * e->dx);
+            active[nActive++] = e;
+        }
+        // Insertion sort by X; the order rarely changes between scanlines
+        for(uint16_t i=1; i<nActive; i++) {
+            GFXedge *e = active[i];
+            uint16_t j = i;
+            for(; j && (active[j - 1]->xc > e->xc); j--) {
+                active[j] = active[j - 1];
+            }
+            active[j] = e;
+        }
+        // Emit runs between crossings that are inside per the fill rule
+        int16_t winding = 0;
+        for(uint16_t i=0; i+1<nActive; i++) {
+            winding += (rule == GFX_POLY_NONZERO) ? active[i]->wind : 1;
+            boolean inside = (rule == GFX_POLY_NONZERO) ?
+              (winding != 0) : (winding & 1);
+            if(!inside) continue;
+            // Pixel px is inside if its center px + 0.5 is at or past
+            // the left crossing and before the right one, so the run is
+            // ceil(xc - 0.5) up to (not including) the same of the right
+            int32_t xa = (active[i    ]->xc + 0x7FFF) >> 16,
+                    xb = (active[i + 1]->xc + 0x7FFF) >> 16;
+            if(xa < 0)       xa = 0;
+            if(xb > _width)  xb = _width;
+            if(xa < xb) writeFastHLine(xa, sy, xb - xa, color);
+        }
+    }
+    endWrite();
+
+    if(edge != edgeBuf) {
+        free(edge);
+        free(active);
+    }
+}
+
+// Fill a polygon (PROGMEM vertices) using the given fill rule
+void Adafruit_GFX::fillPolygon(int16_t x, int16_t y,
+  const int16_t points[], uint16_t n, uint16_t color, uint8_t rule) {
+    scanPolygon(x, y, points, n, color, rule, true);
+}
+
+// Fill a polygon (RAM vertices) using the given fill rule
+void Adafruit_GFX::fillPolygon(int16_t x, int16_t y,
+  int16_t *points, uint16_t n, uint16_t color, uint8_t rule) {
+    scanPolygon(x, y, points, n, color, rule, false);
+}
+
 // BITMAP / XBITMAP / GRAYSCALE / RGB BITMAP FUNCTIONS ---------------------
 
 // Draw a PROGMEM-resident 1-bit image at the specified (x,y) position,
@@ -704,6 +913,182 @@ void Adafruit_GFX::drawRGBBitmap(int16_t x, int16_t y,
     endWrite();
 }
 
+// ROTATED / SCALED BITMAP FUNCTIONS ----------------------------------------
+
+// Draw a bitmap rotated 'angle' degrees clockwise about its center and
+// scaled by 'scale' (16.16 fixed point, 0x10000 = 1:1), with the center
+// placed at (x,y).  Only rotation and the same scale on both axes are
+// supported, no shear or separate x and y scales.  The center is
+// (w/2,h/2) rounded down, same as drawBitmap(x-w/2, y-h/2, ...) for
+// angle 0 at 1:1.  Each destination pixel is inverse-mapped back into
+// the source in 16.16 fixed point, and for each scanline the range of
+// pixels landing inside the source is solved for up front, so only the
+// pixels of the transformed quad are visited.  Sampling is nearest
+// neighbour.  Good for rotating a logo at runtime instead of storing
+// pre-rendered frames of it in flash.  The source step per pixel is
+// 1/scale, which overflows 16.16 for tiny scales, so scales below
+// GFX_AFFINE_MIN_SCALE are drawn at that scale.
+
+// sin() of 0-90 degrees in 0.16 fixed point (90 is special-cased below)
+static const uint16_t PROGMEM GFXsin90[91] = {
+      0,  1144,  2287,  3430,  4572,  5712,  6850,  7987,
+   9121, 10252, 11380, 12505, 13626, 14742, 15855, 16962,
+  18064, 19161, 20252, 21336, 22415, 23486, 24550, 25607,
+  26656, 27697, 28729, 29753, 30767, 31772, 32768, 33754,
+  34729, 35693, 36647, 37590, 38521, 39441, 40348, 41243,
+  42126, 42995, 43852, 44695, 45525, 46341, 47143, 47930,
+  48703, 49461, 50203, 50931, 51643, 52339, 53020, 53684,
+  54332, 54963, 55578, 56175, 56756, 57319, 57865, 58393,
+  58903, 59396, 59870, 60326, 60764, 61183, 61584, 61966,
+  62328, 62672, 62997, 63303, 63589, 63856, 64104, 64332,
+  64540, 64729, 64898, 65048, 65177, 65287, 65376, 65446,
+  65496, 65526, 65535 };
+
+// sin() of any angle in degrees, 16.16 fixed point
+static int32_t isin(int16_t deg) {
+    deg %= 360;
+    if(deg < 0) deg += 360;
+    if(deg == 90)  return  0x10000;
+    if(deg == 270) return -0x10000;
+    if(deg <= 90)  return  (int32_t)pgm_read_word(&GFXsin90[deg]);
+    if(deg <= 180) return  (int32_t)pgm_read_word(&GFXsin90[180 - deg]);
+    if(deg <= 270) return -(int32_t)pgm_read_word(&GFXsin90[deg - 180]);
+    return -(int32_t)pgm_read_word(&GFXsin90[360 - deg]);
+}
+
+// Ceiling of n / d for d > 0 (C division truncates toward zero)
+static int32_t divCeil(int64_t n, int32_t d) {
+    int32_t q = n / d;
+    return ((n > 0) && (n % d)) ? q + 1 : q;
+}
+
+// Narrow [*lo,*hi] to the steps t where 0 <= a + t * da < lim
+static void affineClip(int32_t a, int32_t da, int32_t lim,
+  int32_t *lo, int32_t *hi) {
+    if(da > 0) {
+        *lo = max(*lo, divCeil(-(int64_t)a, da));
+        *hi = min(*hi, divCeil((int64_t)lim - a, da) - 1);
+    } else if(da < 0) {
+        *lo = max(*lo, divCeil((int64_t)a - lim + 1, -da));
+        *hi = min(*hi, divCeil((int64_t)a + 1, -da) - 1);
+    } else if((a < 0) || (a >= lim)) {
+        *hi = *lo - 1; // No pixels
+    }
+}
+
+#define GFX_AFFINE_RGB     0x01 // 16-bit source (else 1-bit)
+#define GFX_AFFINE_PROGMEM 0x02 // Source in PROGMEM (else RAM)
+
+#define GFX_AFFINE_MIN_SCALE 0x100 // 1/256, a step of 256 texels per pixel
+
+void Adafruit_GFX::drawAffine(int16_t x, int16_t y, const void *bitmap,
+  int16_t w, int16_t h, uint16_t color, int16_t angle, int32_t scale,
+  uint8_t format) {
+
+    if((w <= 0) || (h <= 0) || (scale <= 0)) return;
+    if(scale < GFX_AFFINE_MIN_SCALE) scale = GFX_AFFINE_MIN_SCALE;
+
+    int32_t sn = isin(angle), cs = isin(angle + 90),
+            // Inverse transform, source texels per destination pixel
+            dudx = (int64_t)cs * 0x10000 / scale,
+            dvdx = -((int64_t)sn * 0x10000 / scale),
+            dudy = -dvdx,
+            dvdy = dudx,
+            umax = (int32_t)w << 16,
+            vmax = (int32_t)h << 16;
+
+    // Bounding box of the transformed bitmap, clipped to the display
+    // (one texel wider than the bitmap, allowing for a rounded-down center)
+    int32_t ex = (((int64_t)abs(cs) * (w + 1) + (int64_t)abs(sn) * (h + 1))
+                   * scale >> 33) + 1,
+            ey = (((int64_t)abs(sn) * (w + 1) + (int64_t)abs(cs) * (h + 1))
+                   * scale >> 33) + 1;
+    int16_t xl = max((int32_t)x - ex, (int32_t)0),
+            xr = min((int32_t)x + ex, (int32_t)_width  - 1),
+            yt = max((int32_t)y - ey, (int32_t)0),
+            yb = min((int32_t)y + ey, (int32_t)_height - 1);
+    if((xl > xr) || (yt > yb)) return;
+
+    boolean  rgb  = format & GFX_AFFINE_RGB,
+             pgm  = format & GFX_AFFINE_PROGMEM;
+    int16_t  bw   = (w + 7) / 8; // 1-bit scanline pad = whole byte
+    const uint8_t  *bits = (const uint8_t  *)bitmap;
+    const uint16_t *rgbs = (const uint16_t *)bitmap;
+
+    startWrite();
+    for(int16_t py=yt; py<=yb; py++) {
+        // Source position of the center of pixel (xl, py)
+        int32_t fx = (int32_t)(xl - x) * 0x10000 + 0x8000,
+                fy = (int32_t)(py - y) * 0x10000 + 0x8000,
+                u  = ((int32_t)(w / 2) << 16) + (int32_t)(((int64_t)dudx * fx +
+                       (int64_t)dudy * fy) >> 16),
+                v  = ((int32_t)(h / 2) << 16) + (int32_t)(((int64_t)dvdx * fx +
+                       (int64_t)dvdy * fy) >> 16),
+                lo = 0, hi = xr - xl;
+
+        affineClip(u, dudx, umax, &lo, &hi);
+        affineClip(v, dvdx, vmax, &lo, &hi);
+        if(lo > hi) continue;
+
+        u += lo * dudx;
+        v += lo * dvdx;
+        int16_t run = 0; // Pending run of set 1-bit pixels
+        for(int16_t px = xl + lo; px <= xl + hi; px++, u += dudx, v += dvdx) {
+            uint16_t su = (uint32_t)u >> 16, sv = (uint32_t)v >> 16;
+            if((su >= w) || (sv >= h)) su = sv = 0xFFFF; // Rounding at edge
+            if(rgb) {
+                if(su != 0xFFFF) {
+                    uint32_t i = (uint32_t)sv * w + su;
+                    writePixel(px, py, pgm ? pgm_read_word(&rgbs[i]) : rgbs[i]);
+                }
+                continue;
+            }
+            uint8_t byte = 0;
+            if(su != 0xFFFF) {
+                uint32_t i = (uint32_t)sv * bw + su / 8;
+                byte = (pgm ? pgm_read_byte(&bits[i]) : bits[i]) << (su & 7);
+            }
+            if(byte & 0x80) {
+                run++;
+            } else if(run) {
+                writeFastHLine(px - run, py, run, color);
+                run = 0;
+            }
+        }
+        if(run) writeFastHLine(xl + hi + 1 - run, py, run, color);
+    }
+    endWrite();
+}
+
+// PROGMEM-resident 1-bit image, set bits drawn in 'color' (unset bits
+// are transparent).  Runs of set pixels are drawn as horizontal lines.
+void Adafruit_GFX::drawRotatedBitmap(int16_t x, int16_t y,
+  const uint8_t bitmap[], int16_t w, int16_t h, uint16_t color,
+  int16_t angle, int32_t scale) {
+    drawAffine(x, y, bitmap, w, h, color, angle, scale, GFX_AFFINE_PROGMEM);
+}
+
+// Same as above, RAM-resident 1-bit image (e.g. a GFXcanvas1 buffer)
+void Adafruit_GFX::drawRotatedBitmap(int16_t x, int16_t y,
+  uint8_t *bitmap, int16_t w, int16_t h, uint16_t color,
+  int16_t angle, int32_t scale) {
+    drawAffine(x, y, bitmap, w, h, color, angle, scale, 0);
+}
+
+// PROGMEM-resident 16-bit image (RGB 5/6/5)
+void Adafruit_GFX::drawRotatedRGBBitmap(int16_t x, int16_t y,
+  const uint16_t bitmap[], int16_t w, int16_t h,
+  int16_t angle, int32_t scale) {
+    drawAffine(x, y, bitmap, w, h, 0, angle, scale,
+      GFX_AFFINE_RGB | GFX_AFFINE_PROGMEM);
+}
+
+// RAM-resident 16-bit image (RGB 5/6/5), e.g. a GFXcanvas16 buffer
+void Adafruit_GFX::drawRotatedRGBBitmap(int16_t x, int16_t y,
+  uint16_t *bitmap, int16_t w, int16_t h, int16_t angle, int32_t scale) {
+    drawAffine(x, y, bitmap, w, h, 0, angle, scale, GFX_AFFINE_RGB);
+}
+
 // TEXT- AND CHARACTER-HANDLING FUNCTIONS ----------------------------------
 
 // Draw a character
@@ -749,61 +1134,222 @@ void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c,
         // newlines, returns, non-printable characters, etc.  Calling
         // drawChar() directly with 'bad' characters of font may cause mayhem!
 
-        c -= (uint8_t)pgm_read_byte(&gfxFont->first);
-        GFXglyph *glyph  = &(((GFXglyph *)pgm_read_pointer(&gfxFont->glyph))[c]);
-        uint8_t  *bitmap = (uint8_t *)pgm_read_pointer(&gfxFont->bitmap);
-
-        uint16_t bo = pgm_read_word(&glyph->bitmapOffset);
-        uint8_t  w  = pgm_read_byte(&glyph->width),
-                 h  = pgm_read_byte(&glyph->height);
-        int8_t   xo = pgm_read_byte(&glyph->xOffset),
-                 yo = pgm_read_byte(&glyph->yOffset);
-        uint8_t  xx, yy, bits = 0, bit = 0;
-        int16_t  xo16 = 0, yo16 = 0;
-
-        if(size > 1) {
-            xo16 = xo;
-            yo16 = yo;
-        }
-
-        // Todo: Add character clipping here
-
-        // NOTE: THERE IS NO 'BACKGROUND' COLOR OPTION ON CUSTOM FONTS.
-        // THIS IS ON PURPOSE AND BY DESIGN.  The background color feature
-        // has typically been used with the 'classic' font to overwrite old
-        // screen contents with new data.  This ONLY works because the
-        // characters are a uniform size; it's not a sensible thing to do with
-        // proportionally-spaced fonts with glyphs of varying sizes (and that
-        // may overlap).  To replace previously-drawn text when using a custom
-        // font, use the getTextBounds() function to determine the smallest
-        // rectangle encompassing a string, erase the area with fillRect(),
-        // then draw new text.  This WILL infortunately 'blink' the text, but
-        // is unavoidable.  Drawing 'background' pixels will NOT fix this,
-        // only creates a new set of problems.  Have an idea to work around
-        // this (a canvas object type for MCUs that can afford the RAM and
-        // displays supporting setAddrWindow() and pushColors()), but haven't
-        // implemented this yet.
+        GFXglyph *glyph = getGlyph(c);
+        if(glyph) drawGlyph(x, y, glyph, color, size);
 
-        startWrite();
-        for(yy=0; yy<h; yy++) {
-            for(xx=0; xx<w; xx++) {
-                if(!(bit++ & 7)) {
+    } // End classic vs custom font
+}
+
+// Draw one glyph of the current custom font, e.g. as found by getGlyph()
+void Adafruit_GFX::drawGlyph(int16_t x, int16_t y, GFXglyph *glyph,
+  uint16_t color, uint8_t size) {
+
+    uint8_t  *bitmap;
+    uint16_t bo, len = 0xFFFF; // Compiled-in fonts are trusted
+    if(fontSource) {
+        if(!(bitmap = (uint8_t *)fontSource->getBitmap(glyph, &len))) return;
+        bo = 0;
+    } else {
+        bitmap = (uint8_t *)pgm_read_pointer(&gfxFont->bitmap);
+        bo     = pgm_read_word(&glyph->bitmapOffset);
+    }
+    uint8_t  w  = pgm_read_byte(&glyph->width),
+             h  = pgm_read_byte(&glyph->height);
+    int8_t   xo = pgm_read_byte(&glyph->xOffset),
+             yo = pgm_read_byte(&glyph->yOffset);
+    uint8_t  xx, yy, bits = 0, bit = 0;
+    int16_t  xo16 = 0, yo16 = 0;
+
+    if(size > 1) {
+        xo16 = xo;
+        yo16 = yo;
+    }
+
+    // Todo: Add character clipping here
+
+    // NOTE: THERE IS NO 'BACKGROUND' COLOR OPTION ON CUSTOM FONTS.
+    // THIS IS ON PURPOSE AND BY DESIGN.  The background color feature
+    // has typically been used with the 'classic' font to overwrite old
+    // screen contents with new data.  This ONLY works because the
+    // characters are a uniform size; it's not a sensible thing to do with
+    // proportionally-spaced fonts with glyphs of varying sizes (and that
+    // may overlap).  To replace previously-drawn text when using a custom
+    // font, use the getTextBounds() function to determine the smallest
+    // rectangle encompassing a string, erase the area with fillRect(),
+    // then draw new text.  This WILL infortunately 'blink' the text.
+    // Drawing 'background' pixels will NOT fix this, only creates a new
+    // set of problems.  Where the RAM can be spared, printOpaque() works
+    // around it: the text and its background are drawn on an off-screen
+    // 1-bit canvas, which is then pushed to the display in one go.
+
+    // Set pixels are drawn as horizontal runs, one call per run
+    // rather than per pixel.
+    startWrite();
+    if(pgm_read_byte(&gfxFont->flags) & GFX_FONT_RLE) {
+        uint16_t n = w * h, run,
+                 end = (len > 0xFFFF - bo) ? 0xFFFF : bo + len; // Past data
+        boolean  on = false, hi = true;
+        uint8_t  nib;
+        xx = yy = 0;
+        for(uint16_t pos=0; pos<n; pos+=run, on=!on) {
+            run = 0;
+            do {
+                if(hi) {
+                    if(bo >= end) { // Corrupt: ran out of glyph data
+                        endWrite();
+                        return;
+                    }
                     bits = pgm_read_byte(&bitmap[bo++]);
                 }
-                if(bits & 0x80) {
+                nib  = hi ? (bits >> 4) : (bits & 0x0F);
+                hi   = !hi;
+                run += nib;
+            } while((nib == 15) && (run < n));
+            if(run > n - pos) run = n - pos;
+            // Split run at scanline ends
+            for(uint16_t r=run; r; ) {
+                uint8_t len = min(r, (uint16_t)(w - xx));
+                if(on) {
                     if(size == 1) {
-                        writePixel(x+xo+xx, y+yo+yy, color);
+                        writeFastHLine(x+xo+xx, y+yo+yy, len, color);
                     } else {
                         writeFillRect(x+(xo16+xx)*size, y+(yo16+yy)*size,
-                          size, size, color);
+                          len*size, size, color);
                     }
                 }
-                bits <<= 1;
+                r  -= len;
+                xx += len;
+                if(xx >= w) {
+                    xx = 0;
+                    yy++;
+                }
             }
         }
-        endWrite();
+    } else if(pgm_read_byte(&gfxFont->flags) & GFX_FONT_PAGED) {
+        uint8_t top   = yo & 7, pages = (top + h + 7) / 8;
+        int16_t y0    = y + yo - top; // Display row of first page's bit 0
+        uint8_t shift = y0 & 7;
+        if(pageBuffer && (size == 1) && !rotation) {
+            // Column bytes go straight into the buffer, split across
+            // two display pages unless the baseline is page-aligned.
+            int16_t page = (y0 - shift) / 8, col, nPages = (HEIGHT + 7) / 8;
+            for(uint8_t p=0; p<pages; p++, page++) {
+                for(xx=0; xx<w; xx++) {
+                    bits = pgm_read_byte(&bitmap[bo++]);
+                    col  = x + xo + xx;
+                    if(!bits || (col < 0) || (col >= WIDTH)) continue;
+                    uint16_t b16 = (uint16_t)bits << shift;
+                    for(int16_t pg=page; b16; pg++, b16 >>= 8) {
+                        uint8_t b = b16;
+                        if(!b || (pg < 0) || (pg >= nPages)) continue;
+                        uint8_t *dst = &pageBuffer[pg * WIDTH + col];
+                        if(color == 2) *dst ^=  b;
+                        else if(color) *dst |=  b;
+                        else           *dst &= ~b;
+                    }
+                }
+            }
+        } else {
+            // Any other target: vertical runs within each column byte
+            for(uint8_t p=0; p<pages; p++) {
+                for(xx=0; xx<w; xx++) {
+                    bits = pgm_read_byte(&bitmap[bo++]);
+                    for(int8_t b=0, run=0; bits || run; b++, bits >>= 1) {
+                        if(bits & 1) {
+                            run++;
+                        } else if(run) {
+                            int16_t r = p * 8 + b - run - top; // Glyph row
+                            if(size == 1) {
+                                writeFastVLine(x+xo+xx, y+yo+r, run, color);
+                            } else {
+                                writeFillRect(x+(xo16+xx)*size,
+                                  y+(yo16+r)*size, size, run*size, color);
+                            }
+                            run = 0;
+                        }
+                    }
+                }
+            }
+        }
+    } else {
+        for(yy=0; yy<h; yy++) {
+            uint8_t run = 0;
+            for(int16_t cx=0; cx<=w; cx++) { // One past end flushes run
+                boolean set = false;
+                if(cx < w) {
+                    if(!(bit++ & 7)) {
+                        bits = pgm_read_byte(&bitmap[bo++]);
+                    }
+                    set    = bits & 0x80;
+                    bits <<= 1;
+                }
+                if(set) {
+                    run++;
+                } else if(run) {
+                    if(size == 1) {
+                        writeFastHLine(x+xo+cx-run, y+yo+yy, run, color);
+                    } else {
+                        writeFillRect(x+(xo16+cx-run)*size,
+                          y+(yo16+yy)*size, run*size, size, color);
+                    }
+                    run = 0;
+                }
+            }
+        }
+    }
+    endWrite();
+}
 
-    } // End classic vs custom font
+// UTF-8 decoder state machine, fed one byte at a time.  Returns the
+// codepoint once a sequence is complete, or 0xFFFF while it isn't (and
+// for anything beyond U+FFFF, which is skipped).
+uint16_t Adafruit_GFX::utf8Decode(uint8_t c, uint16_t *code, uint8_t *left) {
+    if(c < 0x80) {            // ASCII
+        *left = 0;
+        return c;
+    }
+    if(c < 0xC0) {            // Continuation byte
+        if(!*left) return 0xFFFF;
+        *code = (*code << 6) | (c & 0x3F);
+        return --(*left) ? 0xFFFF : *code;
+    }
+    if(c < 0xE0) {            // 2-byte sequence
+        *code = c & 0x1F;
+        *left = 1;
+    } else if(c < 0xF0) {     // 3-byte sequence
+        *code = c & 0x0F;
+        *left = 2;
+    } else {                  // 4-byte, outside the BMP: skip it
+        *left = 0;
+    }
+    return 0xFFFF;
+}
+
+// Find the glyph for a character (or codepoint, if the font has ranges)
+// in the current custom font.  NULL if the font doesn't have it.
+GFXglyph *Adafruit_GFX::getGlyph(uint16_t c) {
+    GFXglyph *glyph = (GFXglyph *)pgm_read_pointer(&gfxFont->glyph);
+    uint16_t  n     = pgm_read_word(&gfxFont->rangeCount);
+    if(n) {
+        // Binary search for the last range starting at or before c
+        GFXrange *range = (GFXrange *)pgm_read_pointer(&gfxFont->range);
+        uint16_t  lo    = 0, hi = n;
+        while(lo < hi) {
+            uint16_t mid = (lo + hi) / 2;
+            if(pgm_read_word(&range[mid].first) <= c) lo = mid + 1;
+            else                                      hi = mid;
+        }
+        if(!lo) return NULL;
+        range = &range[lo - 1];
+        if(c > pgm_read_word(&range->last)) return NULL;
+        return &glyph[pgm_read_word(&range->glyphIndex) + c -
+          pgm_read_word(&range->first)];
+    }
+    uint8_t first = pgm_read_byte(&gfxFont->first);
+    if((c < first) || (c > (uint8_t)pgm_read_byte(&gfxFont->last))) {
+        return NULL;
+    }
+    return &glyph[c - first];
 }
 
 #if ARDUINO >= 100
@@ -832,10 +1378,11 @@ void Adafruit_GFX::write(uint8_t c) {
             cursor_y += (int16_t)textsize *
                         (uint8_t)pgm_read_byte(&gfxFont->yAdvance);
         } else if(c != '\r') {
-            uint8_t first = pgm_read_byte(&gfxFont->first);
-            if((c >= first) && (c <= (uint8_t)pgm_read_byte(&gfxFont->last))) {
-                GFXglyph *glyph = &(((GFXglyph *)pgm_read_pointer(
-                  &gfxFont->glyph))[c - first]);
+            // Fonts with codepoint ranges take UTF-8 text
+            uint16_t  code  = pgm_read_word(&gfxFont->rangeCount) ?
+                              utf8Decode(c, &utf8Code, &utf8Left) : c;
+            GFXglyph *glyph = (code != 0xFFFF) ? getGlyph(code) : NULL;
+            if(glyph) {
                 uint8_t   w     = pgm_read_byte(&glyph->width),
                           h     = pgm_read_byte(&glyph->height);
                 if((w > 0) && (h > 0)) { // Is there an associated bitmap?
@@ -845,7 +1392,7 @@ void Adafruit_GFX::write(uint8_t c) {
                         cursor_y += (int16_t)textsize *
                           (uint8_t)pgm_read_byte(&gfxFont->yAdvance);
                     }
-                    drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize);
+                    drawGlyph(cursor_x, cursor_y, glyph, textcolor, textsize);
                 }
                 cursor_x += (uint8_t)pgm_read_byte(&glyph->xAdvance) * (int16_t)textsize;
             }
@@ -872,6 +1419,7 @@ int16_t Adafruit_GFX::getCursorY(void) const {
 
 void Adafruit_GFX::setTextSize(uint8_t s) {
     textsize = (s > 0) ? s : 1;
+    if(fontFamily) pickFamilyFont(textsize);
 }
 
 void Adafruit_GFX::setTextColor(uint16_t c) {
@@ -932,12 +1480,78 @@ void Adafruit_GFX::setFont(const GFXfont *f) {
         // Move cursor pos up 6 pixels so it's at top-left of char.
         cursor_y -= 6;
     }
-    gfxFont = (GFXfont *)f;
+    gfxFont    = (GFXfont *)f;
+    fontFamily = NULL;
+    fontSource = NULL;
+}
+
+// Use a font whose glyph bitmaps are fetched as needed, e.g. a
+// GFXfontFile.  Otherwise like setFont(); setFont() stops using it.
+// Selecting the same source again (e.g. to switch back to it every
+// frame) keeps what was measured in its font; after loading another
+// font into it in place, pass NULL first so that's forgotten.
+void Adafruit_GFX::setFontSource(GFXfontSource *s) {
+    setFont(s ? s->getFont() : NULL);
+    fontSource = s;
+    if(s != measuredSource) {
+        boundsMemo.len = 0;
+        lineFont       = NULL;
+        measuredSource = s;
+    }
+}
+
+// Use a font converted in several sizes (fontconvert with a list of
+// sizes).  setTextSize(n) then selects the size whose line height is
+// nearest n times that of the smallest, drawn 1:1 rather than with
+// n*n-pixel blocks; if no size is within 1/8 of that, the smallest is
+// scaled up as usual.  Call before setTextSize(), or call setTextSize()
+// again after.  Pass NULL (or use setFont()) to stop using a family.
+void Adafruit_GFX::setFontFamily(const GFXfontFamily *f) {
+    if(f) {
+        setFont((GFXfont *)pgm_read_pointer(&((GFXfont **)
+          pgm_read_pointer(&f->font))[0]));
+        fontFamily = (GFXfontFamily *)f;
+        pickFamilyFont(textsize);
+    } else {
+        fontFamily = NULL;
+    }
+}
+
+// Set the page-major frame buffer of a monochrome display such as the
+// SSD1306 (WIDTH columns by HEIGHT/8 pages, LSB on top), or NULL.  Text
+// in GFX_FONT_PAGED fonts is then copied into it a byte at a time
+// rather than drawn pixel by pixel, when unscaled and unrotated.
+// Colors are as on those displays: 0 clears, 2 inverts, else sets.
+void Adafruit_GFX::setPageBuffer(uint8_t *buf) {
+    pageBuffer = buf;
+}
+
+// Select family member for text size 's', see setFontFamily()
+void Adafruit_GFX::pickFamilyFont(uint8_t s) {
+    GFXfont **fonts = (GFXfont **)pgm_read_pointer(&fontFamily->font);
+    uint8_t   n     = pgm_read_byte(&fontFamily->count);
+    GFXfont  *base  = (GFXfont *)pgm_read_pointer(&fonts[0]), *best = base;
+    int16_t   want  = pgm_read_byte(&base->yAdvance) * s, bestDiff = want;
+    for(uint8_t i=1; i<n; i++) {
+        GFXfont *f    = (GFXfont *)pgm_read_pointer(&fonts[i]);
+        int16_t  diff = abs(want - (int16_t)pgm_read_byte(&f->yAdvance));
+        if(diff < bestDiff) {
+            best     = f;
+            bestDiff = diff;
+        }
+    }
+    if((best != base) && (bestDiff * 8 <= want)) { // Native size
+        gfxFont  = best;
+        textsize = 1;
+    } else {                                       // Scale smallest
+        gfxFont  = base;
+        textsize = s;
+    }
 }
 
 // Broke this out as it's used by both the PROGMEM- and RAM-resident
 // getTextBounds() functions.
-void Adafruit_GFX::charBounds(char c, int16_t *x, int16_t *y,
+void Adafruit_GFX::charBounds(uint16_t c, int16_t *x, int16_t *y,
   int16_t *minx, int16_t *miny, int16_t *maxx, int16_t *maxy) {
 
     if(gfxFont) {
@@ -946,11 +1560,8 @@ void Adafruit_GFX::charBounds(char c, int16_t *x, int16_t *y,
             *x  = 0;    // Reset x to zero, advance y by one line
             *y += textsize * (uint8_t)pgm_read_byte(&gfxFont->yAdvance);
         } else if(c != '\r') { // Not a carriage return; is normal char
-            uint8_t first = pgm_read_byte(&gfxFont->first),
-                    last  = pgm_read_byte(&gfxFont->last);
-            if((c >= first) && (c <= last)) { // Char present in this font?
-                GFXglyph *glyph = &(((GFXglyph *)pgm_read_pointer(
-                  &gfxFont->glyph))[c - first]);
+            GFXglyph *glyph = getGlyph(c);
+            if(glyph) { // Char present in this font?
                 uint8_t gw = pgm_read_byte(&glyph->width),
                         gh = pgm_read_byte(&glyph->height),
                         xa = pgm_read_byte(&glyph->xAdvance);
@@ -998,7 +1609,59 @@ void Adafruit_GFX::charBounds(char c, int16_t *x, int16_t *y,
 // Pass string and a cursor position, returns UL corner and W,H.
 void Adafruit_GFX::getTextBounds(char *str, int16_t x, int16_t y,
         int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h) {
-    uint8_t c; // Current character
+    textBounds(str, false, x, y, x1, y1, w, h);
+}
+
+// Same as above, but for PROGMEM strings
+void Adafruit_GFX::getTextBounds(const __FlashStringHelper *str,
+        int16_t x, int16_t y, int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h) {
+    textBounds((const char *)str, true, x, y, x1, y1, w, h);
+}
+
+// getTextBounds() for RAM or PROGMEM strings.  The last query is
+// remembered, so asking again about the same string in the same place
+// and font (e.g. centering a label every frame) costs a comparison with
+// a copy of the string instead of a walk through every glyph's metrics.
+void Adafruit_GFX::textBounds(const char *str, boolean pgm,
+  int16_t x, int16_t y, int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h) {
+    uint32_t n    = 0;                  // String length + 1, once counted
+    boolean  same = (boundsMemo.len > 0);
+    uint8_t  c;                         // Current character
+
+    do { // The copy's NUL ends the comparison before it can overrun
+        c = pgm ? pgm_read_byte(&str[n]) : str[n];
+        if(same && (boundsMemo.text[n] != (char)c)) same = false;
+        n++;
+    } while(c);
+    if(same &&
+       (boundsMemo.font == gfxFont)  && (boundsMemo.size  == textsize) &&
+       (boundsMemo.x    == x)        && (boundsMemo.y     == y)        &&
+       (boundsMemo.wrap == wrap)     && (boundsMemo.width == _width)) {
+        *x1 = boundsMemo.x1;
+        *y1 = boundsMemo.y1;
+        *w  = boundsMemo.w;
+        *h  = boundsMemo.h;
+        return;
+    }
+    boundsMemo.len = 0; // Nothing cached unless the copy below fits
+    if((n <= 0xFFFF) && (n > boundsMemo.room)) {
+        char *t = (char *)realloc(boundsMemo.text, n);
+        if(t) {
+            boundsMemo.text = t;
+            boundsMemo.room = n;
+        }
+    }
+    if(n <= boundsMemo.room) {
+        if(pgm) memcpy_P(boundsMemo.text, str, n);
+        else    memcpy(boundsMemo.text, str, n);
+        boundsMemo.len = n;
+    }
+    boundsMemo.font  = gfxFont;
+    boundsMemo.x     = x;
+    boundsMemo.y     = y;
+    boundsMemo.size  = textsize;
+    boundsMemo.wrap  = wrap;
+    boundsMemo.width = _width;
 
     *x1 = x;
     *y1 = y;
@@ -1006,8 +1669,14 @@ void Adafruit_GFX::getTextBounds(char *str, int16_t x, int16_t y,
 
     int16_t minx = _width, miny = _height, maxx = -1, maxy = -1;
 
-    while((c = *str++))
-        charBounds(c, &x, &y, &minx, &miny, &maxx, &maxy);
+    // Fonts with codepoint ranges take UTF-8 text
+    boolean  utf8 = gfxFont && pgm_read_word(&gfxFont->rangeCount);
+    uint16_t code = 0, cp;
+    uint8_t  left = 0;
+    while((c = pgm ? pgm_read_byte(str++) : *str++)) {
+        cp = utf8 ? utf8Decode(c, &code, &left) : c;
+        if(cp != 0xFFFF) charBounds(cp, &x, &y, &minx, &miny, &maxx, &maxy);
+    }
 
     if(maxx >= minx) {
         *x1 = minx;
@@ -1017,30 +1686,148 @@ void Adafruit_GFX::getTextBounds(char *str, int16_t x, int16_t y,
         *y1 = miny;
         *h  = maxy - miny + 1;
     }
-}
+    boundsMemo.x1 = *x1;
+    boundsMemo.y1 = *y1;
+    boundsMemo.w  = *w;
+    boundsMemo.h  = *h;
+}
+
+// Print one line of text with its background filled (textbgcolor), in
+// any font, without the erase-then-draw flicker: the line is composed
+// on an off-screen 1-bit canvas (kept for reuse) and drawn with a single
+// drawBitmap().  The filled band is the full height of the font and 'w'
+// pixels wide (or the text's width, if more), so shorter text replaces
+// longer text cleanly when given the same 'w'.  Text isn't wrapped.  If
+// the canvas can't be allocated, the text is printed normally.
+void Adafruit_GFX::printOpaque(const char *str, int16_t w) {
+    opaqueText(str, false, w);
+}
+
+void Adafruit_GFX::printOpaque(const __FlashStringHelper *str, int16_t w) {
+    opaqueText((const char *)str, true, w);
+}
+
+void Adafruit_GFX::opaqueText(const char *str, boolean pgm, int16_t w) {
+    if(!gfxFont) {
+        lineTop    = 0;
+        lineBottom = 8;
+        lineFont   = NULL; // Measure again on returning to a custom font
+    } else if(lineFont != gfxFont) {
+        // Font's extent over all its glyphs, measured once per font
+        GFXglyph *glyph = (GFXglyph *)pgm_read_pointer(&gfxFont->glyph);
+        uint16_t  n     = pgm_read_word(&gfxFont->rangeCount), i;
+        if(n) {
+            GFXrange *r = &((GFXrange *)pgm_read_pointer(&gfxFont->range))[n-1];
+            n = pgm_read_word(&r->glyphIndex) + pgm_read_word(&r->last) -
+                pgm_read_word(&r->first) + 1;
+        } else {
+            n = pgm_read_byte(&gfxFont->last) -
+                pgm_read_byte(&gfxFont->first) + 1;
+        }
+        lineTop = lineBottom = 0;
+        for(i=0; i<n; i++) {
+            int8_t  yo = pgm_read_byte(&glyph[i].yOffset);
+            uint8_t h  = pgm_read_byte(&glyph[i].height);
+            if(!h) continue;
+            if(yo < lineTop) lineTop = yo;
+            if(yo + h > lineBottom) lineBottom = yo + h;
+        }
+        lineFont = gfxFont;
+    }
 
-// Same as above, but for PROGMEM strings
-void Adafruit_GFX::getTextBounds(const __FlashStringHelper *str,
-        int16_t x, int16_t y, int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h) {
-    uint8_t *s = (uint8_t *)str, c;
+    int16_t tw = pgm ? getTextWidth((const __FlashStringHelper *)str) :
+                       getTextWidth(str),
+            th = (lineBottom - lineTop) * textsize;
+    if(tw > w) w = tw;
+    if((w <= 0) || (th <= 0)) return;
+
+    // The canvas only ever grows, so it's reused for anything that fits
+    if(!lineCanvas || (lineCanvas->width() < w) ||
+       (lineCanvas->height() < th)) {
+        int16_t cw = (w + 7) & ~7, ch = th;
+        if(lineCanvas) {
+            if(lineCanvas->width()  > cw) cw = lineCanvas->width();
+            if(lineCanvas->height() > ch) ch = lineCanvas->height();
+            delete lineCanvas;
+        }
+        lineCanvas = new GFXcanvas1(cw, ch);
+        if(!lineCanvas->getBuffer()) {
+            delete lineCanvas;
+            lineCanvas = NULL;
+        }
+    }
+    if(!lineCanvas) {
+        if(pgm) print((const __FlashStringHelper *)str);
+        else    print(str);
+        return;
+    }
 
-    *x1 = x;
-    *y1 = y;
-    *w  = *h = 0;
+    lineCanvas->fillScreen(0);
+    if(fontSource) lineCanvas->setFontSource(fontSource);
+    else           lineCanvas->setFont(gfxFont);
+    lineCanvas->setTextSize(textsize);
+    lineCanvas->setTextWrap(false);
+    lineCanvas->cp437(_cp437);
+    lineCanvas->setTextColor(1);
+    lineCanvas->setCursor(0, -lineTop * textsize);
+    if(pgm) lineCanvas->print((const __FlashStringHelper *)str);
+    else    lineCanvas->print(str);
+
+    // Pack the rows to 'w' pixels so they can go out as one bitmap,
+    // which a display like Adafruit_SPITFT writes in bulk
+    uint8_t *buf    = lineCanvas->getBuffer();
+    uint16_t stride = (lineCanvas->width() + 7) / 8, bw = (w + 7) / 8;
+    if(stride != bw) {
+        for(int16_t r=1; r<th; r++) memmove(&buf[r * bw], &buf[r * stride], bw);
+    }
+    drawBitmap(cursor_x, cursor_y + lineTop * textsize, buf, w, th,
+      textcolor, textbgcolor);
+    cursor_x += tw;
+}
 
-    int16_t minx = _width, miny = _height, maxx = -1, maxy = -1;
+// Width of a string as printed, i.e. how far the cursor advances (of the
+// longest line, if several), ignoring wrap.  Much cheaper than
+// getTextBounds() when glyph extents don't matter: one glyph table read
+// per character.
+uint16_t Adafruit_GFX::getTextWidth(const char *str) {
+    return textWidth(str, false);
+}
 
-    while((c = pgm_read_byte(s++)))
-        charBounds(c, &x, &y, &minx, &miny, &maxx, &maxy);
+uint16_t Adafruit_GFX::getTextWidth(const __FlashStringHelper *str) {
+    return textWidth((const char *)str, true);
+}
 
-    if(maxx >= minx) {
-        *x1 = minx;
-        *w  = maxx - minx + 1;
+uint16_t Adafruit_GFX::textWidth(const char *str, boolean pgm) {
+    uint16_t  w = 0, line = 0, code = 0, cp;
+    uint8_t   c, left = 0, first = 0, last = 0;
+    GFXglyph *glyph = NULL;
+    boolean   utf8  = false;
+
+    if(gfxFont) { // Look up the font's table once, not per character
+        glyph = (GFXglyph *)pgm_read_pointer(&gfxFont->glyph);
+        first = pgm_read_byte(&gfxFont->first);
+        last  = pgm_read_byte(&gfxFont->last);
+        utf8  = pgm_read_word(&gfxFont->rangeCount);
     }
-    if(maxy >= miny) {
-        *y1 = miny;
-        *h  = maxy - miny + 1;
+    while((c = pgm ? pgm_read_byte(str++) : *str++)) {
+        if(c == '\n') {
+            if(line > w) w = line;
+            line = 0;
+        } else if(c == '\r') {
+            continue;
+        } else if(!gfxFont) {
+            line += 6;
+        } else if(utf8) {
+            if((cp = utf8Decode(c, &code, &left)) != 0xFFFF) {
+                GFXglyph *g = getGlyph(cp);
+                if(g) line += (uint8_t)pgm_read_byte(&g->xAdvance);
+            }
+        } else if((c >= first) && (c <= last)) {
+            line += (uint8_t)pgm_read_byte(&glyph[c - first].xAdvance);
+        }
     }
+    if(line > w) w = line;
+    return w * textsize;
 }
 
 // Return the size of the display (per current rotation)
@@ -1150,7 +1937,7 @@ boolean Adafruit_GFX_Button::justReleased() { return (!currstate && laststate);
 // NOT EXTENSIVELY TESTED YET.  MAY CONTAIN WORST BUGS KNOWN TO HUMANKIND.
 
 GFXcanvas1::GFXcanvas1(uint16_t w, uint16_t h) : Adafruit_GFX(w, h) {
-    uint16_t bytes = ((w + 7) / 8) * h;
+    uint32_t bytes = ((w + 7) / 8) * h;
     if((buffer = (uint8_t *)malloc(bytes))) {
         memset(buffer, 0, bytes);
     }
@@ -1164,6 +1951,22 @@ uint8_t* GFXcanvas1::getBuffer(void) {
     return buffer;
 }
 
+// Write the canvas as a binary PBM ('P4') image, set pixels white, e.g.
+// to Serial or a file to compare with a known-good rendering.  This is
+// the buffer as stored, i.e. unrotated.
+void GFXcanvas1::writePBM(Print *out) const {
+    if(!buffer) return;
+    out->print(F("P4\n"));
+    out->print(WIDTH);
+    out->print(' ');
+    out->print(HEIGHT);
+    out->print('\n');
+    // PBM rows are padded to whole bytes too, but 1 is black
+    for(uint32_t i=0, n=(uint32_t)(WIDTH + 7) / 8 * HEIGHT; i<n; i++) {
+        out->write(buffer[i] ^ 0xFF);
+    }
+}
+
 void GFXcanvas1::drawPixel(int16_t x, int16_t y, uint16_t color) {
 #ifdef __AVR__
     // Bitmask tables of 0x80>>X and ~(0x80>>X), because X>>Y is slow on AVR
@@ -1206,26 +2009,377 @@ void GFXcanvas1::drawPixel(int16_t x, int16_t y, uint16_t color) {
 
 void GFXcanvas1::fillScreen(uint16_t color) {
     if(buffer) {
-        uint16_t bytes = ((WIDTH + 7) / 8) * HEIGHT;
+        uint32_t bytes = ((WIDTH + 7) / 8) * HEIGHT;
         memset(buffer, color ? 0xFF : 0x00, bytes);
     }
 }
 
+// BUFFER ROTATION --------------------------------------------------------
+
+// rotateInto() writes this canvas' buffer, turned through r * 90 degrees
+// clockwise, into another canvas of the same type.  The destination must
+// be HEIGHT x WIDTH for r = 1 or 3 (WIDTH x HEIGHT for 0 or 2) and ends up
+// holding exactly what drawing the same scene into it with setRotation(r)
+// would have produced.  For things drawn once and shown rotated, that's
+// one pass over the finished buffer instead of a coordinate swap inside
+// every drawPixel().  Both canvases' own rotation settings are ignored;
+// returns false on a size mismatch.  flip() mirrors a buffer in place.
+
+// Bit-reverse a byte (MSB-first pixel order to LSB-first and back)
+static inline uint8_t reverse8(uint8_t b) {
+    b = (b >> 4) | (b << 4);
+    b = ((b & 0xCC) >> 2) | ((b & 0x33) << 2);
+    return ((b & 0xAA) >> 1) | ((b & 0x55) << 1);
+}
+
+// Transpose an 8x8 bit block in place: a[i] bit (7-j) <-> a[j] bit (7-i).
+// Hacker's Delight transpose8 on two 32-bit halves.
+static void transpose8(uint8_t a[8]) {
+    uint32_t x = ((uint32_t)a[0] << 24) | ((uint32_t)a[1] << 16) |
+                 ((uint32_t)a[2] <<  8) |            a[3],
+             y = ((uint32_t)a[4] << 24) | ((uint32_t)a[5] << 16) |
+                 ((uint32_t)a[6] <<  8) |            a[7], t;
+
+    t = (x ^ (x >>  7)) & 0x00AA00AA; x ^= t ^ (t <<  7);
+    t = (y ^ (y >>  7)) & 0x00AA00AA; y ^= t ^ (t <<  7);
+    t = (x ^ (x >> 14)) & 0x0000CCCC; x ^= t ^ (t << 14);
+    t = (y ^ (y >> 14)) & 0x0000CCCC; y ^= t ^ (t << 14);
+    t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+    y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+    x = t;
+
+    a[0] = x >> 24; a[1] = x >> 16; a[2] = x >> 8; a[3] = x;
+    a[4] = y >> 24; a[5] = y >> 16; a[6] = y >> 8; a[7] = y;
+}
+
+// OR 8 MSB-first pixels into a 1-bit scanline starting at pixel x.  x may
+// be as low as -7, in which case the leading (off-canvas) bits are lost.
+static inline void orByteAt(uint8_t *row, int16_t x, uint8_t bits) {
+    if(x < 0) {
+        row[0] |= bits << -x;
+        return;
+    }
+    uint8_t s = x & 7;
+    row    += x >> 3;
+    row[0] |= bits >> s;
+    if(s) row[1] |= bits << (8 - s);
+}
+
+boolean GFXcanvas1::rotateInto(GFXcanvas1 *dest, uint8_t r) {
+    r &= 3;
+    int16_t dw = (r & 1) ? HEIGHT : WIDTH,
+            dh = (r & 1) ? WIDTH  : HEIGHT;
+    if(!buffer || !dest || (dest == this) || !dest->buffer ||
+       (dest->WIDTH != dw) || (dest->HEIGHT != dh)) return false;
+
+    uint16_t sbw = (WIDTH + 7) / 8, dbw = (dw + 7) / 8;
+
+    if(!(r & 1)) {
+        memcpy(dest->buffer, buffer, (uint32_t)sbw * HEIGHT);
+        if(r == 2) dest->flip(true, true);
+        return true;
+    }
+
+    // 90 or 270: walk the source in 8x8 blocks, transpose each one so
+    // that every byte holds one source column, and drop those bytes into
+    // the destination rows (bit-reversed and possibly unaligned for 90).
+    uint8_t blk[8];
+    memset(dest->buffer, 0, (uint32_t)dbw * dh);
+    for(int16_t sy=0; sy<HEIGHT; sy+=8) {
+        for(uint16_t bx=0; bx<sbw; bx++) {
+            for(uint8_t i=0; i<8; i++) {
+                blk[i] = (sy + i < HEIGHT) ?
+                  buffer[(uint32_t)(sy + i) * sbw + bx] : 0;
+            }
+            transpose8(blk);
+            for(uint8_t j=0; j<8; j++) {
+                int16_t sx = bx * 8 + j;
+                if(sx >= WIDTH) break;
+                if(r == 1) { // (sx,sy) -> (dw-1-sy, sx)
+                    orByteAt(&dest->buffer[(uint32_t)sx * dbw],
+                      dw - 8 - sy, reverse8(blk[j]));
+                } else {     // (sx,sy) -> (sy, dh-1-sx)
+                    dest->buffer[(uint32_t)(dh - 1 - sx) * dbw + sy / 8] =
+                      blk[j];
+                }
+            }
+        }
+    }
+    return true;
+}
+
+void GFXcanvas1::flip(boolean horizontal, boolean vertical) {
+    if(!buffer) return;
+    uint16_t bw = (WIDTH + 7) / 8;
+    if(vertical) {
+        uint8_t *a = buffer, *b = &buffer[(uint32_t)(HEIGHT - 1) * bw], t;
+        for(; a < b; b -= 2 * bw) {
+            for(uint16_t i=0; i<bw; i++, a++, b++) {
+                t = *a; *a = *b; *b = t;
+            }
+        }
+    }
+    if(horizontal) {
+        // Reverse each scanline's bytes and bits, then shift out the
+        // scanline pad, which the reversal moved to the front.
+        uint8_t pad = bw * 8 - WIDTH, *row = buffer, t;
+        for(int16_t y=0; y<HEIGHT; y++, row += bw) {
+            for(uint16_t i=0, j=bw-1; i<=j && j<bw; i++, j--) {
+                t      = reverse8(row[i]);
+                row[i] = reverse8(row[j]);
+                row[j] = t;
+            }
+            if(pad) {
+                for(uint16_t i=0; i<bw; i++) {
+                    row[i] = (row[i] << pad) |
+                      ((i + 1 < bw) ? (row[i + 1] >> (8 - pad)) : 0);
+                }
+            }
+        }
+    }
+}
+
+// BUFFER SCALING ---------------------------------------------------------
+
+// scaleInto() blits this canvas' buffer into another canvas of the same
+// type, magnified 1x to 4x (nearest neighbour) with its top-left corner
+// at (x,y) and clipped to the destination.  Like rotateInto() this works
+// on raw buffer coordinates, ignoring either canvas' rotation.  Render
+// large text or icons small once, then scale them up in one pass rather
+// than drawing a scale-by-scale rectangle per source pixel.  Each source
+// scanline is expanded once and the copies below it are byte copies.
+
+// Each 4-pixel nibble widened to 4*scale bits, indexed [scale-1][nibble]
+static const uint16_t PROGMEM GFXbitScale[4][16] = {
+  { 0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x6, 0x7,
+    0x8, 0x9, 0xA, 0xB, 0xC, 0xD, 0xE, 0xF },
+  { 0x00, 0x03, 0x0C, 0x0F, 0x30, 0x33, 0x3C, 0x3F,
+    0xC0, 0xC3, 0xCC, 0xCF, 0xF0, 0xF3, 0xFC, 0xFF },
+  { 0x000, 0x007, 0x038, 0x03F, 0x1C0, 0x1C7, 0x1F8, 0x1FF,
+    0xE00, 0xE07, 0xE38, 0xE3F, 0xFC0, 0xFC7, 0xFF8, 0xFFF },
+  { 0x0000, 0x000F, 0x00F0, 0x00FF, 0x0F00, 0x0F0F, 0x0FF0, 0x0FFF,
+    0xF000, 0xF00F, 0xF0F0, 0xF0FF, 0xFF00, 0xFF0F, 0xFFF0, 0xFFFF } };
+
+// Store the top n (<= 32) bits of 'bits' into a w-pixel 1-bit scanline
+// starting at pixel x, replacing what was there and clipping both ends.
+static void putBits(uint8_t *row, int16_t w, int16_t x,
+  uint32_t bits, uint8_t n) {
+    if(x < 0) {
+        if(-x >= n) return;
+        bits <<= -x;
+        n     += x;
+        x      = 0;
+    }
+    if(x >= w) return;
+    if(x + n > w) n = w - x;
+
+    uint8_t s = x & 7;
+    row += x >> 3;
+    while(n) {
+        uint8_t take = 8 - s;
+        if(take > n) take = n;
+        uint8_t mask = (0xFF >> s) & (0xFF << (8 - s - take));
+        *row = (*row & ~mask) | (((uint8_t)(bits >> 24) >> s) & mask);
+        bits <<= take;
+        n     -= take;
+        s      = 0;
+        row++;
+    }
+}
+
+void GFXcanvas1::scaleInto(GFXcanvas1 *dest, int16_t x, int16_t y,
+  uint8_t scale) {
+    if(!buffer || !dest || (dest == this) || !dest->buffer ||
+       (scale < 1) || (scale > 4)) return;
+
+    int16_t  dw  = dest->WIDTH, dh = dest->HEIGHT,
+             x0  = max(x, 0), x1 = min(x + WIDTH * scale, dw);
+    uint16_t sbw = (WIDTH + 7) / 8, dbw = (dw + 7) / 8;
+    if(x0 >= x1) return;
+
+    // Bytes of each destination scanline touched, with edge masks
+    uint16_t b0 = x0 >> 3, b1 = (x1 - 1) >> 3;
+    uint8_t  m0 = 0xFF >> (x0 & 7), m1 = 0xFF << (7 - ((x1 - 1) & 7));
+    if(b0 == b1) m0 = m1 = m0 & m1;
+
+    const uint16_t *lut = GFXbitScale[scale - 1];
+    uint8_t nbits = 4 * scale;
+
+    for(int16_t sy=0; sy<HEIGHT; sy++) {
+        int16_t ty = y + sy * scale,
+                y0 = max(ty, 0), y1 = min(ty + scale, dh);
+        if(y0 >= y1) continue;
+
+        // Expand one source scanline into the first visible dest row...
+        const uint8_t *s   = &buffer[(uint32_t)sy * sbw];
+        uint8_t       *row = &dest->buffer[(uint32_t)y0 * dbw];
+        int16_t        dx  = x;
+        for(uint16_t i=0; (i<sbw) && (dx<dw); i++, dx += 8 * scale) {
+            if(dx + 8 * scale <= 0) continue;
+            uint32_t bits = ((uint32_t)pgm_read_word(&lut[s[i] >> 4]) <<
+                               nbits) | pgm_read_word(&lut[s[i] & 0x0F]);
+            uint8_t  n    = (i < sbw - 1) ? 8 * scale :
+                              (WIDTH - i * 8) * scale; // Last byte may be part pad
+            putBits(row, dw, dx, bits << (32 - 2 * nbits), n);
+        }
+
+        // ...then replicate it into the rest
+        for(int16_t yy=y0+1; yy<y1; yy++) {
+            uint8_t *d = &dest->buffer[(uint32_t)yy * dbw];
+            d[b0] = (d[b0] & ~m0) | (row[b0] & m0);
+            if(b1 > b0) {
+                memcpy(&d[b0 + 1], &row[b0 + 1], b1 - b0 - 1);
+                d[b1] = (d[b1] & ~m1) | (row[b1] & m1);
+            }
+        }
+    }
+}
+
+// GFXcanvas8 and GFXcanvas16 share these.  90/270-degree turns are done
+// in GFX_ROTATE_BLOCK-square tiles so the scattered column writes of a
+// transpose hit a handful of cache lines (or flash cache pages) at a time
+// rather than striding across the whole destination for every pixel.
+template <typename T>
+static void rotatePixels(T *dst, const T *src, int16_t w, int16_t h,
+  uint8_t r) {
+    uint32_t n = (uint32_t)w * h;
+    if(r == 0) {
+        memcpy(dst, src, n * sizeof(T));
+    } else if(r == 2) {
+        for(uint32_t i=0; i<n; i++) dst[n - 1 - i] = src[i];
+    } else {
+        for(int16_t by=0; by<h; by+=GFX_ROTATE_BLOCK) {
+            int16_t ey = min(by + GFX_ROTATE_BLOCK, h);
+            for(int16_t bx=0; bx<w; bx+=GFX_ROTATE_BLOCK) {
+                int16_t ex = min(bx + GFX_ROTATE_BLOCK, w);
+                for(int16_t sy=by; sy<ey; sy++) {
+                    const T *s = &src[(uint32_t)sy * w];
+                    if(r == 1) { // (sx,sy) -> (h-1-sy, sx)
+                        T *d = &dst[h - 1 - sy];
+                        for(int16_t sx=bx; sx<ex; sx++)
+                            d[(uint32_t)sx * h] = s[sx];
+                    } else {     // (sx,sy) -> (sy, w-1-sx)
+                        T *d = &dst[sy];
+                        for(int16_t sx=bx; sx<ex; sx++)
+                            d[(uint32_t)(w - 1 - sx) * h] = s[sx];
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Replicate each pixel 'scale' times across, then each row 'scale'
+// times down (with memcpy), clipped to the destination
+template <typename T>
+static void scalePixels(T *dst, int16_t dw, int16_t dh, const T *src,
+  int16_t w, int16_t h, int16_t x, int16_t y, uint8_t scale) {
+    int16_t x0 = max(x, 0), x1 = min(x + w * scale, dw);
+    if(x0 >= x1) return;
+
+    for(int16_t sy=0; sy<h; sy++) {
+        int16_t ty = y + sy * scale,
+                y0 = max(ty, 0), y1 = min(ty + scale, dh);
+        if(y0 >= y1) continue;
+
+        const T *s   = &src[(uint32_t)sy * w + (x0 - x) / scale];
+        T       *row = &dst[(uint32_t)y0 * dw], *d = &row[x0];
+        uint8_t  rep = scale - (x0 - x) % scale; // Copies of 1st pixel
+        for(int16_t n = x1 - x0; n > 0; rep = scale) {
+            T c = *s++;
+            if(rep > n) rep = n;
+            n -= rep;
+            for(uint8_t i=rep; i--; ) *d++ = c;
+        }
+        for(int16_t yy=y0+1; yy<y1; yy++) {
+            memcpy(&dst[(uint32_t)yy * dw + x0], &row[x0],
+              (x1 - x0) * sizeof(T));
+        }
+    }
+}
+
+template <typename T>
+static void flipPixels(T *buf, int16_t w, int16_t h,
+  boolean horizontal, boolean vertical) {
+    T t;
+    if(vertical) {
+        T *a = buf, *b = &buf[(uint32_t)(h - 1) * w];
+        for(; a < b; b -= 2 * w) {
+            for(int16_t i=0; i<w; i++, a++, b++) {
+                t = *a; *a = *b; *b = t;
+            }
+        }
+    }
+    if(horizontal) {
+        for(T *row = buf; row < &buf[(uint32_t)w * h]; row += w) {
+            for(T *a = row, *b = &row[w - 1]; a < b; a++, b--) {
+                t = *a; *a = *b; *b = t;
+            }
+        }
+    }
+}
+
 GFXcanvas8::GFXcanvas8(uint16_t w, uint16_t h) : Adafruit_GFX(w, h) {
     uint32_t bytes = w * h;
     if((buffer = (uint8_t *)malloc(bytes))) {
         memset(buffer, 0, bytes);
     }
+    palette = NULL;
 }
 
 GFXcanvas8::~GFXcanvas8(void) {
-    if(buffer) free(buffer);
+    if(buffer)  free(buffer);
+    if(palette) free(palette);
 }
 
 uint8_t* GFXcanvas8::getBuffer(void) {
     return buffer;
 }
 
+// Indexed-color mode: GFXcanvas8 pixel values become indices into a
+// 256-entry RGB565 palette, which is only allocated (512 bytes) once a
+// palette is first set.  The canvas itself is unaffected; the palette is
+// applied when the buffer is sent to a 16-bit display, e.g. with
+// Adafruit_SPITFT::drawIndexedBitmap(x, y, canvas.getBuffer(),
+// canvas.getPalette(), w, h).  Rewriting palette entries and sending the
+// buffer again recolors everything drawn in those indices, no redraw
+// needed.  Entries not yet set read as black.
+boolean GFXcanvas8::allocPalette(void) {
+    if(!palette && (palette = (uint16_t *)malloc(256 * 2))) {
+        memset(palette, 0, 256 * 2);
+    }
+    return palette != NULL;
+}
+
+// Load n entries, starting at index 'first', from a PROGMEM table
+void GFXcanvas8::setPalette(const uint16_t pal[], uint16_t n, uint8_t first) {
+    if(allocPalette()) {
+        if(n > 256 - first) n = 256 - first;
+        for(uint16_t i=0; i<n; i++) palette[first + i] = pgm_read_word(&pal[i]);
+    }
+}
+
+// Same as above, but from a RAM-resident table
+void GFXcanvas8::setPalette(uint16_t *pal, uint16_t n, uint8_t first) {
+    if(allocPalette()) {
+        if(n > 256 - first) n = 256 - first;
+        memcpy(&palette[first], pal, n * 2);
+    }
+}
+
+void GFXcanvas8::setPaletteColor(uint8_t index, uint16_t color) {
+    if(allocPalette()) palette[index] = color;
+}
+
+uint16_t GFXcanvas8::getPaletteColor(uint8_t index) const {
+    return palette ? palette[index] : 0;
+}
+
+// Returns NULL until a palette has been set
+uint16_t* GFXcanvas8::getPalette(void) {
+    return palette;
+}
+
 void GFXcanvas8::drawPixel(int16_t x, int16_t y, uint16_t color) {
     if(buffer) {
         if((x < 0) || (y < 0) || (x >= _width) || (y >= _height)) return;
@@ -1258,6 +2412,27 @@ void GFXcanvas8::fillScreen(uint16_t color) {
     }
 }
 
+boolean GFXcanvas8::rotateInto(GFXcanvas8 *dest, uint8_t r) {
+    r &= 3;
+    if(!buffer || !dest || (dest == this) || !dest->buffer ||
+       (dest->WIDTH  != ((r & 1) ? HEIGHT : WIDTH)) ||
+       (dest->HEIGHT != ((r & 1) ? WIDTH  : HEIGHT))) return false;
+    rotatePixels(dest->buffer, buffer, WIDTH, HEIGHT, r);
+    return true;
+}
+
+void GFXcanvas8::flip(boolean horizontal, boolean vertical) {
+    if(buffer) flipPixels(buffer, WIDTH, HEIGHT, horizontal, vertical);
+}
+
+void GFXcanvas8::scaleInto(GFXcanvas8 *dest, int16_t x, int16_t y,
+  uint8_t scale) {
+    if(!buffer || !dest || (dest == this) || !dest->buffer ||
+       (scale < 1) || (scale > 4)) return;
+    scalePixels(dest->buffer, dest->WIDTH, dest->HEIGHT,
+      buffer, WIDTH, HEIGHT, x, y, scale);
+}
+
 void GFXcanvas8::writeFastHLine(int16_t x, int16_t y,
   int16_t w, uint16_t color) {
 
@@ -1308,6 +2483,24 @@ uint16_t* GFXcanvas16::getBuffer(void) {
     return buffer;
 }
 
+// Write the canvas as a binary PPM ('P6') image, unrotated as for
+// GFXcanvas1::writePBM()
+void GFXcanvas16::writePPM(Print *out) const {
+    if(!buffer) return;
+    out->print(F("P6\n"));
+    out->print(WIDTH);
+    out->print(' ');
+    out->print(HEIGHT);
+    out->print(F("\n255\n"));
+    for(uint32_t i=0, n=(uint32_t)WIDTH * HEIGHT; i<n; i++) {
+        uint16_t c = buffer[i];
+        uint8_t  r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+        out->write((r << 3) | (r >> 2)); // Replicate high bits so white
+        out->write((g << 2) | (g >> 4)); // stays 255
+        out->write((b << 3) | (b >> 2));
+    }
+}
+
 void GFXcanvas16::drawPixel(int16_t x, int16_t y, uint16_t color) {
     if(buffer) {
         if((x < 0) || (y < 0) || (x >= _width) || (y >= _height)) return;
@@ -1346,3 +2539,236 @@ void GFXcanvas16::fillScreen(uint16_t color) {
     }
 }
 
+boolean GFXcanvas16::rotateInto(GFXcanvas16 *dest, uint8_t r) {
+    r &= 3;
+    if(!buffer || !dest || (dest == this) || !dest->buffer ||
+       (dest->WIDTH  != ((r & 1) ? HEIGHT : WIDTH)) ||
+       (dest->HEIGHT != ((r & 1) ? WIDTH  : HEIGHT))) return false;
+    rotatePixels(dest->buffer, buffer, WIDTH, HEIGHT, r);
+    return true;
+}
+
+void GFXcanvas16::flip(boolean horizontal, boolean vertical) {
+    if(buffer) flipPixels(buffer, WIDTH, HEIGHT, horizontal, vertical);
+}
+
+void GFXcanvas16::scaleInto(GFXcanvas16 *dest, int16_t x, int16_t y,
+  uint8_t scale) {
+    if(!buffer || !dest || (dest == this) || !dest->buffer ||
+       (scale < 1) || (scale > 4)) return;
+    scalePixels(dest->buffer, dest->WIDTH, dest->HEIGHT,
+      buffer, WIDTH, HEIGHT, x, y, scale);
+}
+
+// ALPHA BLENDING ---------------------------------------------------------
+
+// Blend functions for GFXcanvas16.  Alpha is 0 (keep the canvas pixel)
+// to 255 (replace it), reduced to 5 bits for blending, which is as
+// fine as a 5-bit red or blue channel can resolve anyway.  On the MCU a
+// pixel is spread out to 0b00000gggggg00000rrrrr000000bbbbb so all three
+// channels blend in one 32-bit multiply, the gaps catching the carries.
+// Host builds with SSE2 blend 8 pixels per step, with identical results.
+
+// 8-bit alpha to the 0-32 blend weight
+#define GFX_ALPHA5(a) (((uint16_t)(a) + 4) >> 3)
+
+// Blend fg over bg with a 0-32 weight
+static inline uint16_t blend565(uint16_t fg, uint16_t bg, uint8_t a5) {
+    uint32_t f = (fg | ((uint32_t)fg << 16)) & 0x07E0F81F,
+             b = (bg | ((uint32_t)bg << 16)) & 0x07E0F81F;
+    b = (b + ((f - b) * a5 >> 5)) & 0x07E0F81F;
+    return (uint16_t)(b | (b >> 16));
+}
+
+// Blend n pixels from src (or, if src is NULL, the single color 'fg')
+// over dst with a constant 0-32 weight
+static void blendRun(uint16_t *dst, const uint16_t *src, uint16_t fg,
+  uint32_t n, uint8_t a5) {
+    if(!a5) return;
+    if(a5 >= 32) {
+        if(src) memcpy(dst, src, n * 2);
+        else    while(n--) *dst++ = fg;
+        return;
+    }
+#if defined(__SSE2__)
+    const __m128i m5 = _mm_set1_epi16(0x1F), m6 = _mm_set1_epi16(0x3F),
+                  wt = _mm_set1_epi16(a5);
+    __m128i       vf = _mm_set1_epi16(fg);
+    for(; n >= 8; n -= 8, dst += 8) {
+        if(src) {
+            vf   = _mm_loadu_si128((const __m128i *)src);
+            src += 8;
+        }
+        __m128i d = _mm_loadu_si128((const __m128i *)dst), r, g, b;
+        // Per channel d + ((f - d) * a5 >> 5); products fit in 16 bits
+        r = _mm_srli_epi16(d, 11);
+        g = _mm_and_si128(_mm_srli_epi16(d, 5), m6);
+        b = _mm_and_si128(d, m5);
+        r = _mm_add_epi16(r, _mm_srai_epi16(_mm_mullo_epi16(
+              _mm_sub_epi16(_mm_srli_epi16(vf, 11), r), wt), 5));
+        g = _mm_add_epi16(g, _mm_srai_epi16(_mm_mullo_epi16(
+              _mm_sub_epi16(_mm_and_si128(_mm_srli_epi16(vf, 5), m6), g),
+              wt), 5));
+        b = _mm_add_epi16(b, _mm_srai_epi16(_mm_mullo_epi16(
+              _mm_sub_epi16(_mm_and_si128(vf, m5), b), wt), 5));
+        _mm_storeu_si128((__m128i *)dst, _mm_or_si128(_mm_or_si128(
+          _mm_slli_epi16(r, 11), _mm_slli_epi16(g, 5)), b));
+    }
+#endif
+    while(n--) {
+        *dst = blend565(src ? *src++ : fg, *dst, a5);
+        dst++;
+    }
+}
+
+// Blend two RGB565 colors, 'alpha' 0 (all bg) to 255 (all fg)
+uint16_t GFXcanvas16::blendColor(uint16_t fg, uint16_t bg, uint8_t alpha) {
+    return blend565(fg, bg, GFX_ALPHA5(alpha));
+}
+
+// Blend a solid rectangle over the canvas, e.g. to fade or tint a region
+void GFXcanvas16::fillRectAlpha(int16_t x, int16_t y, int16_t w, int16_t h,
+  uint16_t color, uint8_t alpha) {
+    if(!buffer) return;
+    if(x < 0) { w += x; x = 0; }
+    if(y < 0) { h += y; y = 0; }
+    if(x + w > _width)  w = _width  - x;
+    if(y + h > _height) h = _height - y;
+    if((w <= 0) || (h <= 0)) return;
+
+    // A rect in rotated coordinates is still a rect in the buffer
+    int16_t t;
+    switch(rotation) {
+        case 1:
+            t = x; x = WIDTH  - y - h; y = t;
+            t = w; w = h;              h = t;
+            break;
+        case 2:
+            x = WIDTH  - x - w;
+            y = HEIGHT - y - h;
+            break;
+        case 3:
+            t = y; y = HEIGHT - x - w; x = t;
+            t = w; w = h;              h = t;
+            break;
+    }
+    uint8_t a5 = GFX_ALPHA5(alpha);
+    for(uint16_t *row = &buffer[(uint32_t)y * WIDTH + x]; h--; row += WIDTH) {
+        blendRun(row, NULL, color, w, a5);
+    }
+}
+
+void GFXcanvas16::alphaMask(int16_t x, int16_t y, const uint8_t *mask,
+  int16_t w, int16_t h, uint16_t color, boolean pgm) {
+    if(!buffer) return;
+    for(int16_t j=0; j<h; j++) {
+        int16_t py = y + j;
+        if((py < 0) || (py >= _height)) continue;
+        for(int16_t i=0; i<w; i++) {
+            int16_t px = x + i;
+            if((px < 0) || (px >= _width)) continue;
+            uint8_t a5 = GFX_ALPHA5(pgm ?
+              pgm_read_byte(&mask[(uint32_t)j * w + i]) :
+              mask[(uint32_t)j * w + i]);
+            if(!a5) continue;
+            int16_t bx = px, by = py;
+            switch(rotation) {
+                case 1: bx = WIDTH  - 1 - py; by = px;               break;
+                case 2: bx = WIDTH  - 1 - px; by = HEIGHT - 1 - py;  break;
+                case 3: bx = py;              by = HEIGHT - 1 - px;  break;
+            }
+            uint16_t *p = &buffer[(uint32_t)by * WIDTH + bx];
+            *p = blend565(color, *p, a5);
+        }
+    }
+}
+
+// Draw a solid color through a PROGMEM-resident 8-bit alpha mask
+// (one byte per pixel, no scanline padding), e.g. an antialiased icon
+void GFXcanvas16::drawAlphaMask(int16_t x, int16_t y, const uint8_t mask[],
+  int16_t w, int16_t h, uint16_t color) {
+    alphaMask(x, y, mask, w, h, color, true);
+}
+
+// Same as above, RAM-resident mask (e.g. a GFXcanvas8 buffer)
+void GFXcanvas16::drawAlphaMask(int16_t x, int16_t y, uint8_t *mask,
+  int16_t w, int16_t h, uint16_t color) {
+    alphaMask(x, y, mask, w, h, color, false);
+}
+
+// Blend this canvas' buffer over another canvas with a constant alpha,
+// top-left corner at (x,y), clipped to the destination.  Like
+// scaleInto() this works on raw buffer coordinates.  Cross-fade two
+// screens by blending one over a copy of the other at rising alpha.
+void GFXcanvas16::blendInto(GFXcanvas16 *dest, int16_t x, int16_t y,
+  uint8_t alpha) {
+    if(!buffer || !dest || (dest == this) || !dest->buffer) return;
+    int16_t sx = 0, sy = 0, w = WIDTH, h = HEIGHT;
+    if(x < 0) { sx = -x; w += x; x = 0; }
+    if(y < 0) { sy = -y; h += y; y = 0; }
+    if(x + w > (int16_t)dest->WIDTH)  w = dest->WIDTH  - x;
+    if(y + h > (int16_t)dest->HEIGHT) h = dest->HEIGHT - y;
+    if((w <= 0) || (h <= 0)) return;
+
+    uint8_t   a5  = GFX_ALPHA5(alpha);
+    uint16_t *src = &buffer[(uint32_t)sy * WIDTH + sx],
+             *dst = &dest->buffer[(uint32_t)y * dest->WIDTH + x];
+    for(; h--; src += WIDTH, dst += dest->WIDTH) {
+        blendRun(dst, src, 0, w, a5);
+    }
+}
+
+// DITHERING --------------------------------------------------------------
+
+// Grayscale images converted on the way into a GFXcanvas1, see GFXdither
+
+void GFXcanvas1::ditheredBitmap(int16_t x, int16_t y, const uint8_t *bitmap,
+  int16_t w, int16_t h, uint8_t mode, boolean pgm) {
+    if(!buffer || (w <= 0)) return;
+
+    uint16_t  bw   = (w + 7) / 8, cbw = (WIDTH + 7) / 8;
+    uint8_t  *bits = (uint8_t *)malloc(bw),
+             *gray = pgm ? (uint8_t *)malloc(w) : NULL;
+    GFXdither dither(w, mode);
+    if(bits && (gray || !pgm)) {
+        for(int16_t j=0; j<h; j++) {
+            int16_t py = y + j;
+            if(py >= _height) break;
+            const uint8_t *src = &bitmap[(uint32_t)j * w];
+            if(pgm) {
+                for(int16_t i=0; i<w; i++) gray[i] = pgm_read_byte(&src[i]);
+                src = gray;
+            }
+            // Rows above the canvas are still converted, to carry error
+            dither.ditherRow(src, bits);
+            if(py < 0) continue;
+            if(!rotation) {
+                uint8_t *row = &buffer[(uint32_t)py * cbw];
+                for(uint16_t i=0; i<bw; i++) {
+                    putBits(row, WIDTH, x + i * 8, (uint32_t)bits[i] << 24,
+                      min(w - i * 8, 8));
+                }
+            } else {
+                for(int16_t i=0; i<w; i++) {
+                    drawPixel(x + i, py, (bits[i / 8] << (i & 7)) & 0x80);
+                }
+            }
+        }
+    }
+    if(bits) free(bits);
+    if(gray) free(gray);
+}
+
+// Dither a PROGMEM-resident 8-bit grayscale image (e.g. one stored for
+// drawGrayscaleBitmap()) into the canvas.  Set pixels are white; unlike
+// drawBitmap() both set and clear pixels are drawn.
+void GFXcanvas1::drawDitheredBitmap(int16_t x, int16_t y,
+  const uint8_t bitmap[], int16_t w, int16_t h, uint8_t mode) {
+    ditheredBitmap(x, y, bitmap, w, h, mode, true);
+}
+
+// Same as above, RAM-resident grayscale image
+void GFXcanvas1::drawDitheredBitmap(int16_t x, int16_t y,
+  uint8_t *bitmap, int16_t w, int16_t h, uint8_t mode) {
+    ditheredBitmap(x, y, bitmap, w, h, mode, false);
+}
@@ -9,11 +9,37 @@
 #endif
 #include "gfxfont.h"
 
+// Fill rules for fillPolygon()
+#define GFX_POLY_EVENODD 0 // Inside if crossed an odd number of edges
+#define GFX_POLY_NONZERO 1 // Inside if edge winding doesn't cancel out
+
+// Grayscale to 1-bit conversion modes, see GFXdither.h
+#define GFX_DITHER_THRESHOLD 0 // Plain 50% threshold
+#define GFX_DITHER_BAYER     1 // 8x8 ordered dither, no state
+#define GFX_DITHER_FLOYD     2 // Floyd-Steinberg error diffusion
+
+// Supplier of glyph bitmaps that aren't addressable (e.g. read from a
+// file on demand), see setFontSource().  The GFXfont and its glyph table
+// are in RAM, so this requires a target whose pgm_read_*() also read
+// RAM (ESP8266, ESP32, ARM -- not AVR).
+class GFXfontSource {
+ public:
+  virtual GFXfont       *getFont(void) = 0;
+  // RAM copy of a glyph's bitmap (NULL if unavailable), valid until
+  // the next call, and its length in bytes in 'size'
+  virtual const uint8_t *getBitmap(GFXglyph *glyph, uint16_t *size) = 0;
+};
+
+class GFXcanvas1;
+
 class Adafruit_GFX : public Print {
 
+  friend class GFXtextLayout;
+
  public:
 
   Adafruit_GFX(int16_t w, int16_t h); // Constructor
+  ~Adafruit_GFX(void);
 
   // This MUST be defined by the subclass:
   virtual void drawPixel(int16_t x, int16_t y, uint16_t color) = 0;
@@ -46,7 +72,11 @@ class Adafruit_GFX : public Print {
     fillScreen(uint16_t color),
     // Optional and probably not necessary to change
     drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color),
-    drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+    drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color),
+    // Opaque RAM bitmap, e.g. a GFXcanvas1: worth a bulk write if the
+    // display can (Adafruit_SPITFT does)
+    drawBitmap(int16_t x, int16_t y, uint8_t *bitmap,
+      int16_t w, int16_t h, uint16_t color, uint16_t bg);
 
   // These exist only with Adafruit_GFX (no subclass overrides)
   void
@@ -60,6 +90,14 @@ class Adafruit_GFX : public Print {
       int16_t x2, int16_t y2, uint16_t color),
     fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
       int16_t x2, int16_t y2, uint16_t color),
+    drawPolygon(int16_t x, int16_t y, const int16_t points[], uint16_t n,
+      uint16_t color),
+    drawPolygon(int16_t x, int16_t y, int16_t *points, uint16_t n,
+      uint16_t color),
+    fillPolygon(int16_t x, int16_t y, const int16_t points[], uint16_t n,
+      uint16_t color, uint8_t rule=GFX_POLY_EVENODD),
+    fillPolygon(int16_t x, int16_t y, int16_t *points, uint16_t n,
+      uint16_t color, uint8_t rule=GFX_POLY_EVENODD),
     drawRoundRect(int16_t x0, int16_t y0, int16_t w, int16_t h,
       int16_t radius, uint16_t color),
     fillRoundRect(int16_t x0, int16_t y0, int16_t w, int16_t h,
@@ -70,8 +108,6 @@ class Adafruit_GFX : public Print {
       int16_t w, int16_t h, uint16_t color, uint16_t bg),
     drawBitmap(int16_t x, int16_t y, uint8_t *bitmap,
       int16_t w, int16_t h, uint16_t color),
-    drawBitmap(int16_t x, int16_t y, uint8_t *bitmap,
-      int16_t w, int16_t h, uint16_t color, uint16_t bg),
     drawXBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
       int16_t w, int16_t h, uint16_t color),
     drawGrayscaleBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
@@ -92,6 +128,16 @@ class Adafruit_GFX : public Print {
       int16_t w, int16_t h),
     drawRGBBitmap(int16_t x, int16_t y,
       uint16_t *bitmap, uint8_t *mask, int16_t w, int16_t h),
+    drawRotatedBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
+      int16_t w, int16_t h, uint16_t color, int16_t angle,
+      int32_t scale=0x10000),
+    drawRotatedBitmap(int16_t x, int16_t y, uint8_t *bitmap,
+      int16_t w, int16_t h, uint16_t color, int16_t angle,
+      int32_t scale=0x10000),
+    drawRotatedRGBBitmap(int16_t x, int16_t y, const uint16_t bitmap[],
+      int16_t w, int16_t h, int16_t angle, int32_t scale=0x10000),
+    drawRotatedRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap,
+      int16_t w, int16_t h, int16_t angle, int32_t scale=0x10000),
     drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color,
       uint16_t bg, uint8_t size),
     setCursor(int16_t x, int16_t y),
@@ -101,10 +147,18 @@ class Adafruit_GFX : public Print {
     setTextWrap(boolean w),
     cp437(boolean x=true),
     setFont(const GFXfont *f = NULL),
+    setFontFamily(const GFXfontFamily *f = NULL),
+    setFontSource(GFXfontSource *s),
+    setPageBuffer(uint8_t *buf),
+    printOpaque(const char *str, int16_t w=0),
+    printOpaque(const __FlashStringHelper *s, int16_t w=0),
     getTextBounds(char *string, int16_t x, int16_t y,
       int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h),
     getTextBounds(const __FlashStringHelper *s, int16_t x, int16_t y,
       int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h);
+  uint16_t
+    getTextWidth(const char *str),
+    getTextWidth(const __FlashStringHelper *s);
 
 #if ARDUINO >= 100
   virtual size_t write(uint8_t);
@@ -123,23 +177,69 @@ class Adafruit_GFX : public Print {
 
  protected:
   void
-    charBounds(char c, int16_t *x, int16_t *y,
-      int16_t *minx, int16_t *miny, int16_t *maxx, int16_t *maxy);
+    polygonOutline(int16_t x, int16_t y, const int16_t *points, uint16_t n,
+      uint16_t color, boolean pgm),
+    scanPolygon(int16_t x, int16_t y, const int16_t *points, uint16_t n,
+      uint16_t color, uint8_t rule, boolean pgm),
+    drawAffine(int16_t x, int16_t y, const void *bitmap,
+      int16_t w, int16_t h, uint16_t color, int16_t angle, int32_t scale,
+      uint8_t format),
+    charBounds(uint16_t c, int16_t *x, int16_t *y,
+      int16_t *minx, int16_t *miny, int16_t *maxx, int16_t *maxy),
+    drawGlyph(int16_t x, int16_t y, GFXglyph *glyph, uint16_t color,
+      uint8_t size),
+    textBounds(const char *str, boolean pgm, int16_t x, int16_t y,
+      int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h),
+    opaqueText(const char *str, boolean pgm, int16_t w),
+    pickFamilyFont(uint8_t s);
+  uint16_t
+    textWidth(const char *str, boolean pgm);
+  GFXglyph
+    *getGlyph(uint16_t c);
+  static uint16_t
+    utf8Decode(uint8_t c, uint16_t *code, uint8_t *left);
   const int16_t
     WIDTH, HEIGHT;   // This is the 'raw' display w/h - never changes
   int16_t
     _width, _height, // Display w/h as modified by current rotation
     cursor_x, cursor_y;
   uint16_t
-    textcolor, textbgcolor;
+    textcolor, textbgcolor,
+    utf8Code;  // Codepoint being decoded by write()
   uint8_t
     textsize,
-    rotation;
+    rotation,
+    utf8Left;  // Continuation bytes write() still expects
   boolean
     wrap,   // If set, 'wrap' text at right edge of display
     _cp437; // If set, use correct CP437 charset (default is off)
   GFXfont
     *gfxFont;
+  GFXfontFamily
+    *fontFamily; // If set, setTextSize() picks gfxFont from this
+  GFXfontSource
+    *fontSource, // If set, glyph bitmaps come from here
+    *measuredSource; // Last setFontSource(), for boundsMemo/lineFont
+  uint8_t
+    *pageBuffer; // Page-major frame buffer for GFX_FONT_PAGED text
+  GFXcanvas1
+    *lineCanvas; // Reused by printOpaque()
+  GFXfont
+    *lineFont;   // Font that lineTop/lineBottom were measured for
+  int8_t
+    lineTop,     // Extent of lineFont's glyphs above and below the
+    lineBottom;  // baseline (top is negative)
+  struct {       // Last getTextBounds() query and result
+    char    *text;         // Copy of the string, NUL included
+    uint16_t len,          // String length + 1; 0 if nothing cached
+             room;         // Bytes allocated for text
+    GFXfont *font;
+    int16_t  x, y, width,  // Position and _width queried with
+             x1, y1;
+    uint16_t w, h;
+    uint8_t  size;
+    boolean  wrap;
+  } boundsMemo;
 };
 
 class Adafruit_GFX_Button {
@@ -178,9 +278,19 @@ class GFXcanvas1 : public Adafruit_GFX {
   GFXcanvas1(uint16_t w, uint16_t h);
   ~GFXcanvas1(void);
   void     drawPixel(int16_t x, int16_t y, uint16_t color),
-           fillScreen(uint16_t color);
+           fillScreen(uint16_t color),
+           flip(boolean horizontal, boolean vertical);
+  boolean  rotateInto(GFXcanvas1 *dest, uint8_t r);
+  void     scaleInto(GFXcanvas1 *dest, int16_t x, int16_t y, uint8_t scale),
+           drawDitheredBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
+             int16_t w, int16_t h, uint8_t mode=GFX_DITHER_FLOYD),
+           drawDitheredBitmap(int16_t x, int16_t y, uint8_t *bitmap,
+             int16_t w, int16_t h, uint8_t mode=GFX_DITHER_FLOYD),
+           writePBM(Print *out) const;
   uint8_t *getBuffer(void);
  private:
+  void     ditheredBitmap(int16_t x, int16_t y, const uint8_t *bitmap,
+             int16_t w, int16_t h, uint8_t mode, boolean pgm);
   uint8_t *buffer;
 };
 
@@ -190,11 +300,21 @@ class GFXcanvas8 : public Adafruit_GFX {
   ~GFXcanvas8(void);
   void     drawPixel(int16_t x, int16_t y, uint16_t color),
            fillScreen(uint16_t color),
-           writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+           writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color),
+           setPalette(const uint16_t palette[], uint16_t n=256, uint8_t first=0),
+           setPalette(uint16_t *palette, uint16_t n=256, uint8_t first=0),
+           setPaletteColor(uint8_t index, uint16_t color),
+           flip(boolean horizontal, boolean vertical);
+  boolean   rotateInto(GFXcanvas8 *dest, uint8_t r);
+  void      scaleInto(GFXcanvas8 *dest, int16_t x, int16_t y, uint8_t scale);
 
-  uint8_t *getBuffer(void);
+  uint8_t  *getBuffer(void);
+  uint16_t *getPalette(void);
+  uint16_t  getPaletteColor(uint8_t index) const;
  private:
-  uint8_t *buffer;
+  boolean   allocPalette(void);
+  uint8_t  *buffer;
+  uint16_t *palette;
 };
 
 class GFXcanvas16 : public Adafruit_GFX {
@@ -202,9 +322,23 @@ class GFXcanvas16 : public Adafruit_GFX {
   GFXcanvas16(uint16_t w, uint16_t h);
   ~GFXcanvas16(void);
   void      drawPixel(int16_t x, int16_t y, uint16_t color),
-            fillScreen(uint16_t color);
+            fillScreen(uint16_t color),
+            flip(boolean horizontal, boolean vertical);
+  boolean   rotateInto(GFXcanvas16 *dest, uint8_t r);
+  void      scaleInto(GFXcanvas16 *dest, int16_t x, int16_t y, uint8_t scale);
+  void      fillRectAlpha(int16_t x, int16_t y, int16_t w, int16_t h,
+              uint16_t color, uint8_t alpha),
+            drawAlphaMask(int16_t x, int16_t y, const uint8_t mask[],
+              int16_t w, int16_t h, uint16_t color),
+            drawAlphaMask(int16_t x, int16_t y, uint8_t *mask,
+              int16_t w, int16_t h, uint16_t color),
+            blendInto(GFXcanvas16 *dest, int16_t x, int16_t y, uint8_t alpha),
+            writePPM(Print *out) const;
+  static uint16_t blendColor(uint16_t fg, uint16_t bg, uint8_t alpha);
   uint16_t *getBuffer(void);
  private:
+  void      alphaMask(int16_t x, int16_t y, const uint8_t *mask,
+              int16_t w, int16_t h, uint16_t color, boolean pgm);
   uint16_t *buffer;
 };
 
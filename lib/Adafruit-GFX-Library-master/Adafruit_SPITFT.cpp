@@ -26,6 +26,10 @@
 
 #include "Adafruit_SPITFT_Macros.h"
 
+#if defined(__SSE2__)
+  #include <emmintrin.h>
+#endif
+
 
 
 // Pass 8-bit (each) R,G,B, get back 16-bit packed color
@@ -196,28 +200,36 @@ void inline Adafruit_SPITFT::writePixels(uint16_t * colors, uint32_t len){
 }
 
 void Adafruit_SPITFT::writeColor(uint16_t color, uint32_t len){
-#ifdef SPI_HAS_WRITE_PIXELS
-    if(_sclk >= 0){
-        for (uint32_t t=0; t<len; t++){
-            writePixel(color);
+    uint8_t hi = color >> 8, lo = color;
+#ifdef SPI_HAS_WRITE_PATTERN
+    if(_sclk < 0){
+        // The pattern holds SPI_FILL_PIXELS copies of the last fill color
+        // in wire (MSB-first) order and is only rebuilt when the color
+        // changes.  Being static it starts zeroed, i.e. already black.
+        // Whole patterns go out as one repeated FIFO transfer, so a large
+        // fill costs a couple of calls into the SPI driver, not one per
+        // pixel or per 32-pixel chunk.
+        static uint8_t  pattern[SPI_FILL_PIXELS * 2];
+        static uint16_t patternColor = 0x0000;
+
+        if(color != patternColor){
+            for(uint16_t i=0; i<sizeof(pattern); i+=2){
+                pattern[i]   = hi;
+                pattern[i+1] = lo;
+            }
+            patternColor = color;
         }
-        return;
-    }
-    static uint16_t temp[SPI_MAX_PIXELS_AT_ONCE];
-    size_t blen = (len > SPI_MAX_PIXELS_AT_ONCE)?SPI_MAX_PIXELS_AT_ONCE:len;
-    uint16_t tlen = 0;
-
-    for (uint32_t t=0; t<blen; t++){
-        temp[t] = color;
-    }
 
-    while(len){
-        tlen = (len>blen)?blen:len;
-        writePixels(temp, tlen);
-        len -= tlen;
+        uint32_t blocks = len / SPI_FILL_PIXELS;
+        if(blocks){
+            HSPI_WRITE_PATTERN(pattern, sizeof(pattern), blocks);
+        }
+        if((len %= SPI_FILL_PIXELS)){
+            HSPI_WRITE_PATTERN(pattern, len * 2, 1);
+        }
+        return;
     }
 #else
-    uint8_t hi = color >> 8, lo = color;
     if(_sclk < 0){ //AVR Optimization
         for (uint32_t t=len; t; t--){
             HSPI_WRITE(hi);
@@ -225,11 +237,11 @@ void Adafruit_SPITFT::writeColor(uint16_t color, uint32_t len){
         }
         return;
     }
+#endif
     for (uint32_t t=len; t; t--){
         spiWrite(hi);
         spiWrite(lo);
     }
-#endif
 }
 
 void Adafruit_SPITFT::writePixel(int16_t x, int16_t y, uint16_t color) {
@@ -336,4 +348,163 @@ void Adafruit_SPITFT::drawRGBBitmap(int16_t x, int16_t y,
     endWrite();
 }
 
+// 1-bit to RGB565 expansion, used to push GFXcanvas1 buffers and other
+// RAM-resident bitmaps to the display in bulk.  On MCUs each source byte
+// becomes two lookups into a 16-entry table of 4-pixel runs, built once
+// per bitmap for the current fg/bg pair; host builds with SSE2 instead
+// expand a byte to 8 pixels with one compare and select.
+static void buildMonoLUT(uint16_t lut[16][4], uint16_t fg, uint16_t bg) {
+    for(uint8_t n=0; n<16; n++) {
+        for(uint8_t i=0; i<4; i++) {
+            lut[n][i] = (n & (0x8 >> i)) ? fg : bg;
+        }
+    }
+}
+
+// Expand 'len' pixels starting 'bit' bits (0-7) into src[0], MSB first
+static void expandMono(uint16_t *dst, const uint8_t *src, uint8_t bit,
+  uint16_t len, const uint16_t lut[16][4]) {
+    uint16_t fg = lut[15][0], bg = lut[0][0];
+
+    // Leading bits up to the next byte boundary
+    if(bit) {
+        uint8_t byte = *src++ << bit;
+        for(; bit < 8 && len; bit++, len--, byte <<= 1) {
+            *dst++ = (byte & 0x80) ? fg : bg;
+        }
+    }
+#if defined(__SSE2__)
+    const __m128i bits = _mm_set_epi16(0x01, 0x02, 0x04, 0x08,
+                                       0x10, 0x20, 0x40, 0x80);
+    const __m128i vfg  = _mm_set1_epi16(fg), vbg = _mm_set1_epi16(bg);
+    for(; len >= 8; len -= 8, dst += 8) {
+        __m128i m = _mm_and_si128(_mm_set1_epi16(*src++), bits);
+        m = _mm_cmpeq_epi16(m, bits);
+        _mm_storeu_si128((__m128i *)dst, _mm_or_si128(
+          _mm_and_si128(m, vfg), _mm_andnot_si128(m, vbg)));
+    }
+#else
+    for(; len >= 8; len -= 8, dst += 8) {
+        uint8_t byte = *src++;
+        memcpy(dst    , lut[byte >> 4  ], 8);
+        memcpy(dst + 4, lut[byte & 0x0F], 8);
+    }
+#endif
+    // Trailing partial byte
+    if(len) {
+        uint8_t byte = *src;
+        for(; len; len--, byte <<= 1) *dst++ = (byte & 0x80) ? fg : bg;
+    }
+}
+
+// Draw a RAM-resident 1-bit image (e.g. a GFXcanvas1 buffer) using the
+// specified foreground (set bits) and background (unset bits) colors.
+// Same result as the Adafruit_GFX version, but scanlines are expanded
+// in bulk and streamed into a single address window rather than sent as
+// one addressed writePixel() per pixel.
+void Adafruit_SPITFT::drawBitmap(int16_t x, int16_t y, uint8_t *bitmap,
+  int16_t w, int16_t h, uint16_t color, uint16_t bg) {
+
+    int16_t x2, y2; // Lower-right coord
+    if(( x             >= _width ) ||      // Off-edge right
+       ( y             >= _height) ||      // " top
+       ((x2 = (x+w-1)) <  0      ) ||      // " left
+       ((y2 = (y+h-1)) <  0)     ) return; // " bottom
+
+    int16_t bx1=0, by1=0,         // Clipped top-left within bitmap
+            byteWidth = (w+7)/8;  // Bitmap scanline pad = whole byte
+    if(x < 0) { // Clip left
+        w  +=  x;
+        bx1 = -x;
+        x   =  0;
+    }
+    if(y < 0) { // Clip top
+        h  +=  y;
+        by1 = -y;
+        y   =  0;
+    }
+    if(x2 >= _width ) w = _width  - x; // Clip right
+    if(y2 >= _height) h = _height - y; // Clip bottom
+
+#ifdef SPI_HAS_WRITE_BYTES
+    // Expand straight into wire (MSB-first) byte order so each chunk
+    // can go out as raw bytes with no per-pixel swap.
+    boolean raw = (_sclk < 0);
+    if(raw) {
+        color = (color << 8) | (color >> 8);
+        bg    = (bg    << 8) | (bg    >> 8);
+    }
+#endif
+    uint16_t lut[16][4], line[SPI_EXPAND_PIXELS];
+    buildMonoLUT(lut, color, bg);
+
+    bitmap += by1 * byteWidth + bx1 / 8; // Offset to clipped top-left
+    startWrite();
+    setAddrWindow(x, y, w, h); // Clipped area
+    while(h--) { // For each (clipped) scanline...
+        uint8_t  *p   = bitmap;
+        uint8_t   bit = bx1 & 7;
+        for(int16_t n=w; n > 0; n -= SPI_EXPAND_PIXELS) {
+            uint16_t len = (n > SPI_EXPAND_PIXELS) ? SPI_EXPAND_PIXELS : n;
+            expandMono(line, p, bit, len, lut);
+            p += (bit + len) / 8;
+            bit = (bit + len) & 7;
+#ifdef SPI_HAS_WRITE_BYTES
+            if(raw) {
+                HSPI_WRITE_BYTES((uint8_t *)line, len * 2);
+                continue;
+            }
+#endif
+            writePixels(line, len);
+        }
+        bitmap += byteWidth; // Advance pointer by one full (unclipped) line
+    }
+    endWrite();
+}
+
+// Draw a RAM-resident 8-bit indexed image (e.g. a GFXcanvas8 buffer),
+// mapping each byte through a 256-entry RGB565 palette on the way out.
+// Pixels are expanded SPI_EXPAND_PIXELS at a time into a small stack
+// buffer, so no 16-bit copy of the image is ever held in RAM.
+void Adafruit_SPITFT::drawIndexedBitmap(int16_t x, int16_t y,
+  uint8_t *pindex, uint16_t *palette, int16_t w, int16_t h) {
+
+    int16_t x2, y2; // Lower-right coord
+    if(!palette                      ||
+       ( x             >= _width ) ||      // Off-edge right
+       ( y             >= _height) ||      // " top
+       ((x2 = (x+w-1)) <  0      ) ||      // " left
+       ((y2 = (y+h-1)) <  0)     ) return; // " bottom
+
+    int16_t bx1=0, by1=0, // Clipped top-left within bitmap
+            saveW=w;      // Save original bitmap width value
+    if(x < 0) { // Clip left
+        w  +=  x;
+        bx1 = -x;
+        x   =  0;
+    }
+    if(y < 0) { // Clip top
+        h  +=  y;
+        by1 = -y;
+        y   =  0;
+    }
+    if(x2 >= _width ) w = _width  - x; // Clip right
+    if(y2 >= _height) h = _height - y; // Clip bottom
+
+    uint16_t line[SPI_EXPAND_PIXELS];
+    pindex += by1 * saveW + bx1; // Offset bitmap ptr to clipped top-left
+    startWrite();
+    setAddrWindow(x, y, w, h); // Clipped area
+    while(h--) { // For each (clipped) scanline...
+        uint8_t *p = pindex;
+        for(int16_t n=w; n > 0; n -= SPI_EXPAND_PIXELS) {
+            uint16_t len = (n > SPI_EXPAND_PIXELS) ? SPI_EXPAND_PIXELS : n;
+            for(uint16_t i=0; i<len; i++) line[i] = palette[*p++];
+            writePixels(line, len);
+        }
+        pindex += saveW; // Advance pointer by one full (unclipped) line
+    }
+    endWrite();
+}
+
 #endif // !__AVR_ATtiny85__
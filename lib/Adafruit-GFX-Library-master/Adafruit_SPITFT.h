@@ -56,6 +56,11 @@ class Adafruit_SPITFT : public Adafruit_GFX {
         using     Adafruit_GFX::drawRGBBitmap; // Check base class first
         void      drawRGBBitmap(int16_t x, int16_t y,
                     uint16_t *pcolors, int16_t w, int16_t h);
+        using     Adafruit_GFX::drawBitmap; // Check base class first
+        void      drawBitmap(int16_t x, int16_t y, uint8_t *bitmap,
+                    int16_t w, int16_t h, uint16_t color, uint16_t bg);
+        void      drawIndexedBitmap(int16_t x, int16_t y, uint8_t *pindex,
+                    uint16_t *palette, int16_t w, int16_t h);
 
         uint16_t  color565(uint8_t r, uint8_t g, uint8_t b);
 
@@ -71,12 +71,27 @@
 #ifdef ESP32
     #define SPI_HAS_WRITE_PIXELS
 #endif
+#if defined(ESP8266) || defined(ESP32)
+    #define SPI_HAS_WRITE_PATTERN
+    // Pixels held in the writeColor() fill pattern.  writePattern() takes
+    // at most 64 bytes (the ESP8266 hardware FIFO; its size is a uint8_t
+    // on both cores), so 32 is the largest value that works.
+    #ifndef SPI_FILL_PIXELS
+        #define SPI_FILL_PIXELS     32
+    #endif
+    #if (SPI_FILL_PIXELS < 1) || (SPI_FILL_PIXELS > 32)
+        #error "SPI_FILL_PIXELS must be 1 to 32 (writePattern() takes up to 64 bytes)"
+    #endif
+#endif
 #if defined(ESP8266) || defined(ESP32)
     // Optimized SPI (ESP8266 and ESP32)
     #define HSPI_READ()              SPI_OBJECT.transfer(0)
     #define HSPI_WRITE(b)            SPI_OBJECT.write(b)
     #define HSPI_WRITE16(s)          SPI_OBJECT.write16(s)
     #define HSPI_WRITE32(l)          SPI_OBJECT.write32(l)
+    #define HSPI_WRITE_PATTERN(d,s,r) SPI_OBJECT.writePattern(d,s,r)
+    #define SPI_HAS_WRITE_BYTES
+    #define HSPI_WRITE_BYTES(d,n)    SPI_OBJECT.writeBytes(d,n)
     #ifdef SPI_HAS_WRITE_PIXELS
         #define SPI_MAX_PIXELS_AT_ONCE  32
         #define HSPI_WRITE_PIXELS(c,l)   SPI_OBJECT.writePixels(c,l)
@@ -106,6 +121,13 @@ static inline uint8_t _avr_spi_read(void) {
     #define HSPI_WRITE_PIXELS(c,l)   for(uint32_t i=0; i<(l); i+=2){ HSPI_WRITE(((uint8_t*)(c))[i+1]); HSPI_WRITE(((uint8_t*)(c))[i]); }
 #endif
 
+// Pixels expanded per bulk write by drawIndexedBitmap() and the 1-bit
+// drawBitmap().  Costs twice this many bytes of stack; keep it a
+// multiple of 8.
+#ifndef SPI_EXPAND_PIXELS
+    #define SPI_EXPAND_PIXELS   32
+#endif
+
 #define SPI_BEGIN()             if(_sclk < 0){SPI_OBJECT.begin();}
 #define SPI_BEGIN_TRANSACTION() if(_sclk < 0){HSPI_BEGIN_TRANSACTION();}
 #define SPI_END_TRANSACTION()   if(_sclk < 0){HSPI_END_TRANSACTION();}
@@ -0,0 +1,129 @@
+/*
+GFXanimation plays 'GFXA' data (see GFXanimation.h) into a page-major
+buffer, e.g. the SSD1306's, applying each frame's changes in place.
+*/
+
+#include "GFXanimation.h"
+
+GFXanimation::GFXanimation(void) {
+    data = NULL;
+}
+
+// Start playing 'len' bytes of animation from PROGMEM (e.g. sizeof the
+// array) into 'buf', which must hold width x pages bytes.  Returns false
+// if the data isn't a GFXA animation.
+boolean GFXanimation::begin(const uint8_t d[], uint32_t len, uint8_t *b) {
+    return init(d, len, b, true);
+}
+
+// Same, animation data in RAM (e.g. read from SPIFFS)
+boolean GFXanimation::begin(uint8_t *d, uint32_t len, uint8_t *b) {
+    return init(d, len, b, false);
+}
+
+boolean GFXanimation::init(const uint8_t *d, uint32_t len, uint8_t *b,
+  boolean p) {
+    uint8_t hdr[12];
+    data = NULL;
+    if(len < sizeof(hdr)) return false;
+    for(uint8_t i=0; i<sizeof(hdr); i++) {
+        hdr[i] = p ? pgm_read_byte(&d[i]) : d[i];
+    }
+    if(memcmp(hdr, "GFXA", 4) || (hdr[4] != GFX_ANIM_VERSION) ||
+       !hdr[5] || !hdr[6] || (hdr[6] > 8) || !(hdr[8] | hdr[9])) {
+        return false;
+    }
+    data    = d;
+    end     = d + len;
+    buf     = b;
+    pgm     = p;
+    width   = hdr[5];
+    pages   = hdr[6];
+    frames  = hdr[8]  | (hdr[9]  << 8);
+    frameMs = hdr[10] | (hdr[11] << 8);
+    rewind();
+    return true;
+}
+
+// Go back to the first frame (always a keyframe)
+void GFXanimation::rewind(void) {
+    pos   = data + 12;
+    frame = 0;
+}
+
+// True if 'n' more bytes are left in the data
+boolean GFXanimation::have(uint16_t n) {
+    return (uint32_t)(end - pos) >= n;
+}
+
+uint8_t GFXanimation::readByte(void) {
+    return pgm ? pgm_read_byte(pos++) : *pos++;
+}
+
+// Apply the next frame to the buffer, going back to the start after the
+// last one.  Returns a bit mask of the pages that changed (bit 0 = page
+// 0); getDirty() tells which of their columns did.  Stops playing
+// (returning 0 from then on) if the data turns out to be malformed or
+// shorter than its header says.
+uint8_t GFXanimation::nextFrame(void) {
+    if(!data) return 0;
+    if(frame >= frames) rewind();
+    frame++;
+
+    uint8_t mask = 0, type, p, x, n;
+    for(p=0; p<pages; p++) {
+        dirtyX0[p] = 0xFF;
+        dirtyX1[p] = 0;
+    }
+    type = have(1) ? readByte() : 0xFF; // Data ends before the last frame
+    if(type == GFX_ANIM_KEY) {
+        uint16_t len = width * pages;
+        if(!have(len)) {
+            data = NULL;
+            return 0;
+        }
+        for(uint16_t i=0; i<len; i++) buf[i] = readByte();
+        for(p=0; p<pages; p++) {
+            dirtyX0[p] = 0;
+            dirtyX1[p] = width - 1;
+        }
+        return 0xFF >> (8 - pages);
+    }
+    if(type != GFX_ANIM_DELTA) {
+        data = NULL;
+        return 0;
+    }
+    while(have(1) && ((p = readByte()) != 0xFF)) {
+        if(!have(2)) break;
+        x = readByte();
+        n = readByte();
+        if((p >= pages) || !n || (x + n > width) || !have(n)) break;
+        mask |= 1 << p;
+        if(x < dirtyX0[p])         dirtyX0[p] = x;
+        if(x + n - 1 > dirtyX1[p]) dirtyX1[p] = x + n - 1;
+        for(uint8_t *b = &buf[p * width + x]; n--; ) *b++ ^= readByte();
+    }
+    if(p != 0xFF) data = NULL; // Malformed or cut short
+    return mask;
+}
+
+// First and last column of 'page' changed by the last nextFrame(), for
+// pages whose bit it returned
+void GFXanimation::getDirty(uint8_t page, uint8_t *x0, uint8_t *x1) const {
+    *x0 = dirtyX0[page];
+    *x1 = dirtyX1[page];
+}
+
+// Number of frames played since the start (1 after the first frame)
+uint16_t GFXanimation::getFrame(void) const {
+    return frame;
+}
+
+uint16_t GFXanimation::getFrameCount(void) const {
+    return frames;
+}
+
+// How long each frame is shown, in milliseconds
+uint16_t GFXanimation::getFrameTime(void) const {
+    return frameMs;
+}
@@ -0,0 +1,56 @@
+#ifndef _GFXANIMATION_H_
+#define _GFXANIMATION_H_
+
+#include "Adafruit_GFX.h"
+
+// Player for delta-encoded animations ('GFXA', made with
+// tools/anim_encode.js) on page-major frame buffers like the SSD1306's.
+// Each frame is either a keyframe (a whole buffer) or a list of runs of
+// bytes to XOR into the buffer in place, so a frame costs flash and bus
+// time in proportion to what changed:
+//
+//   uint8_t pages = anim.nextFrame(); // Bit n set if page n changed
+//   for each page p in 'pages': anim.getDirty(p, &x0, &x1) and send
+//   columns x0 to x1 of page p to the display
+//
+// All values are little-endian:
+//
+//   0   'G' 'F' 'X' 'A'   Magic
+//   4   uint8_t  version  1
+//   5   uint8_t  width    Columns (bytes per page)
+//   6   uint8_t  pages    8-row pages, 1 to 8
+//   7   uint8_t  reserved 0
+//   8   uint16_t frames
+//   10  uint16_t frameMs  Display time of each frame
+//   12  frames: uint8_t type, then
+//       GFX_ANIM_KEY:   width x pages bytes, page by page
+//       GFX_ANIM_DELTA: runs of uint8_t page, column, length (1-255),
+//                       then 'length' bytes to XOR; page 0xFF ends it
+#define GFX_ANIM_VERSION 1
+#define GFX_ANIM_KEY     0
+#define GFX_ANIM_DELTA   1
+
+class GFXanimation {
+ public:
+  GFXanimation(void);
+  boolean  begin(const uint8_t data[], uint32_t len, uint8_t *buf),
+           begin(uint8_t *data, uint32_t len, uint8_t *buf);
+  void     rewind(void),
+           getDirty(uint8_t page, uint8_t *x0, uint8_t *x1) const;
+  uint8_t  nextFrame(void);
+  uint16_t getFrame(void) const,
+           getFrameCount(void) const,
+           getFrameTime(void) const;
+ private:
+  boolean  init(const uint8_t *data, uint32_t len, uint8_t *buf,
+             boolean pgm),
+           have(uint16_t n);
+  uint8_t  readByte(void);
+  const uint8_t *data, *pos, *end;
+  uint8_t  *buf, width, pages,
+           dirtyX0[8], dirtyX1[8]; // Columns changed by the last frame
+  uint16_t frames, frame, frameMs;
+  boolean  pgm;
+};
+
+#endif // _GFXANIMATION_H_
@@ -0,0 +1,220 @@
+/*
+GFXcounter passes draw calls on to another Adafruit_GFX, counting them
+(see GFXcounter.h).
+*/
+
+#include "GFXcounter.h"
+
+GFXcounter::GFXcounter(Adafruit_GFX *t, void (*f)(void)) :
+  Adafruit_GFX(t->width(), t->height()) {
+    target = t;
+    flush  = f;
+    drawn  = NULL;
+    reset();
+}
+
+GFXcounter::~GFXcounter(void) {
+    if(drawn) free(drawn);
+}
+
+// Zero the counters, e.g. at the start of each frame
+void GFXcounter::reset(void) {
+    for(uint8_t i=0; i<GFX_COUNT_TYPES; i++) calls[i] = time[i] = 0;
+    pixels = overdraw = 0;
+    if(drawn) memset(drawn, 0, (WIDTH * HEIGHT + 7) / 8);
+}
+
+// Start (or stop) counting overdraw.  Returns false if there isn't the
+// RAM for it.
+boolean GFXcounter::trackOverdraw(boolean on) {
+    if(!on) {
+        if(drawn) free(drawn);
+        drawn = NULL;
+    } else if(!drawn) {
+        if(!(drawn = (uint8_t *)calloc((WIDTH * HEIGHT + 7) / 8, 1))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Tally a call that started at micros() 'start' and covered the given
+// rectangle (clipped to the display)
+void GFXcounter::count(uint8_t type, uint32_t start, int16_t x, int16_t y,
+  int16_t w, int16_t h) {
+    time[type] += micros() - start;
+    calls[type]++;
+    if(w < 0) {
+        x += w + 1;
+        w  = -w;
+    }
+    if(h < 0) {
+        y += h + 1;
+        h  = -h;
+    }
+    if(x < 0) {
+        w += x;
+        x  = 0;
+    }
+    if(y < 0) {
+        h += y;
+        y  = 0;
+    }
+    if(x + w > _width)  w = _width  - x;
+    if(y + h > _height) h = _height - y;
+    if((w <= 0) || (h <= 0)) return;
+    pixels += (uint32_t)w * h;
+    if(!drawn) return;
+    for(int16_t j=y; j<y+h; j++) {
+        uint32_t i = (uint32_t)j * _width + x;
+        for(int16_t n=w; n--; i++) {
+            uint8_t bit = 0x80 >> (i & 7);
+            if(drawn[i >> 3] & bit) overdraw++;
+            else                    drawn[i >> 3] |= bit;
+        }
+    }
+}
+
+void GFXcounter::drawPixel(int16_t x, int16_t y, uint16_t color) {
+    uint32_t t = micros();
+    target->drawPixel(x, y, color);
+    count(GFX_COUNT_PIXEL, t, x, y, 1, 1);
+}
+
+void GFXcounter::writePixel(int16_t x, int16_t y, uint16_t color) {
+    uint32_t t = micros();
+    target->writePixel(x, y, color);
+    count(GFX_COUNT_PIXEL, t, x, y, 1, 1);
+}
+
+void GFXcounter::drawFastHLine(int16_t x, int16_t y, int16_t w,
+  uint16_t color) {
+    uint32_t t = micros();
+    target->drawFastHLine(x, y, w, color);
+    count(GFX_COUNT_HLINE, t, x, y, w, 1);
+}
+
+void GFXcounter::writeFastHLine(int16_t x, int16_t y, int16_t w,
+  uint16_t color) {
+    uint32_t t = micros();
+    target->writeFastHLine(x, y, w, color);
+    count(GFX_COUNT_HLINE, t, x, y, w, 1);
+}
+
+void GFXcounter::drawFastVLine(int16_t x, int16_t y, int16_t h,
+  uint16_t color) {
+    uint32_t t = micros();
+    target->drawFastVLine(x, y, h, color);
+    count(GFX_COUNT_VLINE, t, x, y, 1, h);
+}
+
+void GFXcounter::writeFastVLine(int16_t x, int16_t y, int16_t h,
+  uint16_t color) {
+    uint32_t t = micros();
+    target->writeFastVLine(x, y, h, color);
+    count(GFX_COUNT_VLINE, t, x, y, 1, h);
+}
+
+void GFXcounter::fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+  uint16_t color) {
+    uint32_t t = micros();
+    target->fillRect(x, y, w, h, color);
+    count(GFX_COUNT_RECT, t, x, y, w, h);
+}
+
+void GFXcounter::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+  uint16_t color) {
+    uint32_t t = micros();
+    target->writeFillRect(x, y, w, h, color);
+    count(GFX_COUNT_RECT, t, x, y, w, h);
+}
+
+void GFXcounter::drawBitmap(int16_t x, int16_t y, uint8_t *bitmap,
+  int16_t w, int16_t h, uint16_t color, uint16_t bg) {
+    uint32_t t = micros();
+    target->drawBitmap(x, y, bitmap, w, h, color, bg);
+    count(GFX_COUNT_BITMAP, t, x, y, w, h);
+}
+
+void GFXcounter::fillScreen(uint16_t color) {
+    uint32_t t = micros();
+    target->fillScreen(color);
+    count(GFX_COUNT_SCREEN, t, 0, 0, _width, _height);
+}
+
+void GFXcounter::startWrite(void) {
+    calls[GFX_COUNT_WRITE]++;
+    target->startWrite();
+}
+
+void GFXcounter::endWrite(void) {
+    target->endWrite();
+}
+
+// Rotates the target too; reset() afterwards if counting overdraw
+void GFXcounter::setRotation(uint8_t r) {
+    target->setRotation(r);
+    rotation = target->getRotation();
+    _width   = target->width();
+    _height  = target->height();
+}
+
+void GFXcounter::invertDisplay(boolean i) {
+    target->invertDisplay(i);
+}
+
+// Send the frame to the display with the function given when created
+void GFXcounter::display(void) {
+    if(!flush) return;
+    uint32_t t = micros();
+    flush();
+    time[GFX_COUNT_FLUSH] += micros() - t;
+    calls[GFX_COUNT_FLUSH]++;
+}
+
+// Number of calls of a GFX_COUNT_* type since reset()
+uint32_t GFXcounter::getCalls(uint8_t type) const {
+    return (type < GFX_COUNT_TYPES) ? calls[type] : 0;
+}
+
+// Microseconds spent in calls of a GFX_COUNT_* type since reset()
+uint32_t GFXcounter::getTime(uint8_t type) const {
+    return (type < GFX_COUNT_TYPES) ? time[type] : 0;
+}
+
+// Pixels covered by all calls, on the display, since reset()
+uint32_t GFXcounter::getPixels(void) const {
+    return pixels;
+}
+
+// How many of those had already been drawn since reset()
+uint32_t GFXcounter::getOverdraw(void) const {
+    return overdraw;
+}
+
+// Print the counters, one line per type of call that was made
+void GFXcounter::report(Print *out) const {
+    static const char PROGMEM names[] =
+      "pixel\0hline\0vline\0rect\0bitmap\0screen\0write\0flush";
+    const char *name = names;
+    for(uint8_t i=0; i<GFX_COUNT_TYPES; i++) {
+        if(calls[i]) {
+            char c;
+            for(const char *p=name; (c = pgm_read_byte(p)); p++) out->write(c);
+            out->print(' ');
+            out->print(calls[i]);
+            out->print(F(" calls, "));
+            out->print(time[i]);
+            out->println(F(" us"));
+        }
+        while(pgm_read_byte(name++));
+    }
+    out->print(pixels);
+    out->print(F(" pixels, "));
+    if(drawn) {
+        out->print(overdraw);
+        out->println(F(" overdrawn"));
+    } else {
+        out->println(F("overdraw not tracked"));
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef _GFXCOUNTER_H_
+#define _GFXCOUNTER_H_
+
+#include "Adafruit_GFX.h"
+
+// Draw-call types counted by GFXcounter
+#define GFX_COUNT_PIXEL  0 // drawPixel(), writePixel()
+#define GFX_COUNT_HLINE  1 // drawFastHLine(), writeFastHLine()
+#define GFX_COUNT_VLINE  2 // drawFastVLine(), writeFastVLine()
+#define GFX_COUNT_RECT   3 // fillRect(), writeFillRect()
+#define GFX_COUNT_BITMAP 4 // drawBitmap() of a RAM bitmap with background
+#define GFX_COUNT_SCREEN 5 // fillScreen()
+#define GFX_COUNT_WRITE  6 // startWrite() transactions
+#define GFX_COUNT_FLUSH  7 // display()
+#define GFX_COUNT_TYPES  8
+
+// Instrumentation: draws everything on another display or canvas while
+// counting the calls that reach it, by type, with the time they took and
+// the pixels they covered.  Everything else (lines, circles, text...)
+// is broken down by Adafruit_GFX into those calls, so draw through the
+// counter to see what a screen costs:
+//
+//   void oledDisplay(void) { oled.display(); }
+//   GFXcounter screen(&oled, oledDisplay);
+//   ...draw on 'screen', then screen.display();
+//   screen.report(&Serial);
+//   screen.reset();                 // Start counting the next frame
+//
+// Times are in microseconds from micros(), so mostly of use on the host
+// or for bigger calls.  Overdraw (pixels drawn more than once since
+// reset()) is only counted after trackOverdraw(true), which allocates a
+// bit per pixel.  Lines are counted as the spans and pixels they draw.
+class GFXcounter : public Adafruit_GFX {
+ public:
+  GFXcounter(Adafruit_GFX *target, void (*flush)(void)=NULL);
+  ~GFXcounter(void);
+  using Adafruit_GFX::drawBitmap; // Other overloads still draw per pixel
+  void
+    drawPixel(int16_t x, int16_t y, uint16_t color),
+    writePixel(int16_t x, int16_t y, uint16_t color),
+    drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color),
+    writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color),
+    drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color),
+    writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color),
+    fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color),
+    writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+      uint16_t color),
+    drawBitmap(int16_t x, int16_t y, uint8_t *bitmap, int16_t w, int16_t h,
+      uint16_t color, uint16_t bg),
+    fillScreen(uint16_t color),
+    startWrite(void),
+    endWrite(void),
+    setRotation(uint8_t r),
+    invertDisplay(boolean i),
+    display(void),
+    reset(void),
+    report(Print *out) const;
+  boolean  trackOverdraw(boolean on);
+  uint32_t
+    getCalls(uint8_t type) const,
+    getTime(uint8_t type) const,
+    getPixels(void) const,
+    getOverdraw(void) const;
+ private:
+  void     count(uint8_t type, uint32_t start, int16_t x, int16_t y,
+             int16_t w, int16_t h);
+  Adafruit_GFX *target;
+  void     (*flush)(void);
+  uint8_t  *drawn; // Bit per pixel drawn since reset(), or NULL
+  uint32_t calls[GFX_COUNT_TYPES], time[GFX_COUNT_TYPES],
+           pixels, overdraw;
+};
+
+#endif // _GFXCOUNTER_H_
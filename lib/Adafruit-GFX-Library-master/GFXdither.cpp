@@ -0,0 +1,151 @@
+/*
+GFXdither turns 8-bit grayscale (0 = black, 255 = white) into 1-bit
+pixels, set where the result is white.  Rows come out either packed
+MSB-first like a GFXcanvas1 scanline, or OR'd into a page-major
+buffer laid out like SSD1306 display memory (8 rows per byte, LSB on
+top).  Converting on the fly means images no longer need thresholding
+offline, and only a single scanline needs to be in RAM at once.
+*/
+
+#include "GFXdither.h"
+#if defined(__SSE2__)
+  #include <emmintrin.h>
+#endif
+
+#ifndef min
+#define min(a,b) (((a) < (b)) ? (a) : (b))
+#endif
+
+// Bit-reverse a byte (MSB-first pixel order to LSB-first and back)
+static inline uint8_t reverse8(uint8_t b) {
+    b = (b >> 4) | (b << 4);
+    b = ((b & 0xCC) >> 2) | ((b & 0x33) << 2);
+    return ((b & 0xAA) >> 1) | ((b & 0x55) << 1);
+}
+
+// 8x8 Bayer matrix; a pixel is set if gray > 4 * entry + 2
+static const uint8_t PROGMEM GFXbayer8[8][8] = {
+  {  0, 32,  8, 40,  2, 34, 10, 42 },
+  { 48, 16, 56, 24, 50, 18, 58, 26 },
+  { 12, 44,  4, 36, 14, 46,  6, 38 },
+  { 60, 28, 52, 20, 62, 30, 54, 22 },
+  {  3, 35, 11, 43,  1, 33,  9, 41 },
+  { 51, 19, 59, 27, 49, 17, 57, 25 },
+  { 15, 47,  7, 39, 13, 45,  5, 37 },
+  { 63, 31, 55, 23, 61, 29, 53, 21 } };
+
+GFXdither::GFXdither(int16_t w, uint8_t m) {
+    width = w;
+    mode  = m;
+    err   = NULL;
+    line  = (uint8_t *)malloc((w + 7) / 8); // Packed row for ditherRowPaged()
+    if(mode == GFX_DITHER_FLOYD) {
+        // Error line, one entry per pixel plus one for column -1
+        err = (int16_t *)malloc((w + 1) * sizeof(int16_t));
+    }
+    reset();
+}
+
+GFXdither::~GFXdither(void) {
+    if(err)  free(err);
+    if(line) free(line);
+}
+
+// Start a new image at row 0
+void GFXdither::reset(void) {
+    row = 0;
+    if(err) memset(err, 0, (width + 1) * sizeof(int16_t));
+}
+
+// Row number the next call to ditherRow() will convert
+int16_t GFXdither::getRow(void) const {
+    return row;
+}
+
+// Convert one row of 'width' gray pixels into (width+7)/8 packed bytes
+void GFXdither::ditherRow(const uint8_t *gray, uint8_t *bits) {
+    int16_t x    = 0;
+    uint8_t byte = 0;
+
+    if((mode == GFX_DITHER_FLOYD) && err) {
+        // err[x+1] holds the error pushed down onto pixel x by the row
+        // above.  Going left to right, next row's terms trail one pixel
+        // behind in 'below' and 'right' and overwrite the spent entries.
+        int16_t ahead = 0, below = 0, right = 0;
+        for(; x<width; x++) {
+            int16_t v = gray[x] + err[x + 1] + ahead, e;
+            if(v >= 128) {
+                byte |= 0x80 >> (x & 7);
+                e     = v - 255;
+            } else {
+                e     = v;
+            }
+            int16_t e3 = (e * 3) >> 4, e5 = (e * 5) >> 4, e1 = e >> 4;
+            ahead  = e - e3 - e5 - e1;    // 7/16, plus rounding leftovers
+            err[x] = below + e3;          // Down-left neighbour is done
+            below  = right + e5;
+            right  = e1;
+            if((x & 7) == 7) {
+                *bits++ = byte;
+                byte    = 0;
+            }
+        }
+        err[x] = below;
+    } else if(mode == GFX_DITHER_BAYER) {
+        uint8_t thr[8];
+        for(uint8_t i=0; i<8; i++) {
+            thr[i] = pgm_read_byte(&GFXbayer8[row & 7][i]) * 4 + 2;
+        }
+#if defined(__SSE2__)
+        // 16 pixels per compare (unsigned, via sign flip); movemask puts
+        // the first pixel in bit 0, so each byte is bit-reversed on store
+        const __m128i flip = _mm_set1_epi8((char)0x80);
+        __m128i t = _mm_xor_si128(_mm_set_epi8(
+          thr[7], thr[6], thr[5], thr[4], thr[3], thr[2], thr[1], thr[0],
+          thr[7], thr[6], thr[5], thr[4], thr[3], thr[2], thr[1], thr[0]),
+          flip);
+        for(; x + 16 <= width; x += 16) {
+            __m128i g = _mm_xor_si128(
+              _mm_loadu_si128((const __m128i *)&gray[x]), flip);
+            uint16_t m = _mm_movemask_epi8(_mm_cmpgt_epi8(g, t));
+            *bits++ = reverse8(m);
+            *bits++ = reverse8(m >> 8);
+        }
+#endif
+        for(; x<width; x++) {
+            if(gray[x] > thr[x & 7]) byte |= 0x80 >> (x & 7);
+            if((x & 7) == 7) {
+                *bits++ = byte;
+                byte    = 0;
+            }
+        }
+    } else {
+        for(; x<width; x++) {
+            if(gray[x] >= 128) byte |= 0x80 >> (x & 7);
+            if((x & 7) == 7) {
+                *bits++ = byte;
+                byte    = 0;
+            }
+        }
+    }
+    if(x & 7) *bits = byte;
+    row++;
+}
+
+// Convert one row and OR it into row getRow() of a page-major buffer
+// 'bufWidth' pixels across (e.g. an SSD1306 display buffer), which
+// should be cleared first.  Pixels past bufWidth are dropped.
+void GFXdither::ditherRowPaged(const uint8_t *gray, uint8_t *buf,
+  int16_t bufWidth) {
+    if(!line) return;
+    uint8_t *col = &buf[(uint32_t)(row / 8) * bufWidth],
+             bit = 1 << (row & 7);
+    int16_t  w   = min(width, bufWidth);
+    ditherRow(gray, line);
+    for(int16_t x=0; x<w; x += 8) {
+        uint8_t b = line[x / 8];
+        for(int16_t i=x; b && (i<w); i++, b <<= 1) {
+            if(b & 0x80) col[i] |= bit;
+        }
+    }
+}
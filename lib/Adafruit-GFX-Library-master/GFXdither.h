@@ -0,0 +1,22 @@
+#ifndef _GFXDITHER_H_
+#define _GFXDITHER_H_
+
+#include "Adafruit_GFX.h"
+
+// Streaming 8-bit grayscale to 1-bit converter.  Feed an image one
+// scanline at a time, top to bottom; Floyd-Steinberg keeps one line of
+// error terms, the other modes keep no state beyond the row number.
+class GFXdither {
+ public:
+  GFXdither(int16_t w, uint8_t mode=GFX_DITHER_FLOYD);
+  ~GFXdither(void);
+  void    reset(void),
+          ditherRow(const uint8_t *gray, uint8_t *bits),
+          ditherRowPaged(const uint8_t *gray, uint8_t *buf, int16_t bufWidth);
+  int16_t getRow(void) const;
+ private:
+  int16_t *err, width, row;
+  uint8_t *line, mode;
+};
+
+#endif // _GFXDITHER_H_
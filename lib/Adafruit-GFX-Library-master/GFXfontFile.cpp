@@ -0,0 +1,178 @@
+/*
+Runtime-loadable GFX fonts, see GFXfontFile.h for the file format.
+*/
+
+#if defined(ESP8266) || defined(ESP32)
+
+#include "GFXfontFile.h"
+
+#define LE16(p) ((uint16_t)(p)[0] | ((uint16_t)(p)[1] << 8))
+#define LE32(p) ((uint32_t)LE16(p) | ((uint32_t)LE16((p) + 2) << 16))
+
+GFXfontFile::GFXfontFile(void) {
+    glyphs    = NULL;
+    ranges    = NULL;
+    cache     = NULL;
+    slotOf    = NULL;
+    glyphLen  = NULL;
+    slotGlyph = NULL;
+    slotUsed  = NULL;
+    nSlots    = 0;
+}
+
+GFXfontFile::~GFXfontFile(void) {
+    end();
+}
+
+// Open a font file and load its tables.  Up to 'cacheSize' bytes
+// (at least one glyph's worth) hold recently drawn glyph bitmaps.
+// Returns false if the file is missing, malformed or won't fit in RAM.
+boolean GFXfontFile::begin(fs::FS &fs, const char *path,
+  uint16_t cacheSize) {
+    uint8_t  hdr[20], rec[9];
+    uint16_t i, nRanges;
+    uint32_t bitmapSize;
+
+    end();
+    if(!(file = fs.open(path, "r"))) return false;
+    if((file.read(hdr, sizeof(hdr)) != sizeof(hdr)) ||
+       memcmp(hdr, "GFXF", 4) || (hdr[4] != GFX_FONT_FILE_VERSION)) {
+        end();
+        return false;
+    }
+    glyphCount = LE16(&hdr[10]);
+    nRanges    = LE16(&hdr[12]);
+    slotSize   = LE16(&hdr[14]);
+    bitmapSize = LE32(&hdr[16]);
+    if(!slotSize) slotSize = 1;
+    nSlots     = constrain(cacheSize / slotSize, 1, 254);
+
+    if(!(glyphs    = (GFXglyph *)malloc(glyphCount * sizeof(GFXglyph))) ||
+       !(glyphLen  = (uint16_t *)malloc(glyphCount * sizeof(uint16_t))) ||
+       !(slotOf    = (uint8_t  *)malloc(glyphCount)) ||
+       !(ranges    = (GFXrange *)malloc((nRanges ? nRanges : 1) *
+                                        sizeof(GFXrange))) ||
+       !(cache     = (uint8_t  *)malloc(nSlots * slotSize)) ||
+       !(slotGlyph = (uint16_t *)malloc(nSlots * sizeof(uint16_t))) ||
+       !(slotUsed  = (uint32_t *)calloc(nSlots, sizeof(uint32_t)))) {
+        end();
+        return false;
+    }
+
+    // Everything read is checked against the glyph and bitmap counts,
+    // and each glyph's length against what its size needs in the font's
+    // format, so a damaged (or hostile) upload can't make drawing read
+    // outside the glyph.  RLE lengths vary; drawGlyph() stops at the end.
+    uint8_t fmt = hdr[5];
+    for(i=0; i<nRanges; i++) {
+        if(file.read(rec, 6) != 6) break;
+        ranges[i].first      = LE16(&rec[0]);
+        ranges[i].last       = LE16(&rec[2]);
+        ranges[i].glyphIndex = LE16(&rec[4]);
+        if((ranges[i].last < ranges[i].first) ||
+           ((uint32_t)ranges[i].glyphIndex + ranges[i].last -
+            ranges[i].first >= glyphCount)) break;
+    }
+    if(i < nRanges) {
+        end();
+        return false;
+    }
+    for(i=0; i<glyphCount; i++) {
+        if(file.read(rec, 9) != 9) break;
+        glyphs[i].bitmapOffset = LE16(&rec[0]);
+        glyphLen[i]            = LE16(&rec[2]);
+        glyphs[i].width        = rec[4];
+        glyphs[i].height       = rec[5];
+        glyphs[i].xAdvance     = rec[6];
+        glyphs[i].xOffset      = (int8_t)rec[7];
+        glyphs[i].yOffset      = (int8_t)rec[8];
+        uint16_t need = (uint16_t)glyphs[i].width * glyphs[i].height;
+        if(fmt & GFX_FONT_RLE) {
+            need = need ? 1 : 0;
+        } else if(fmt & GFX_FONT_PAGED) {
+            need = ((glyphs[i].yOffset & 7) + glyphs[i].height + 7) / 8 *
+              glyphs[i].width;
+        } else {
+            need = (need + 7) / 8;
+        }
+        if((glyphLen[i] < need) || (glyphLen[i] > slotSize) ||
+           ((uint32_t)glyphs[i].bitmapOffset + glyphLen[i] > bitmapSize)) {
+            break;
+        }
+    }
+    if((i < glyphCount) ||
+       (!nRanges && (hdr[7] - hdr[6] + 1 > (int16_t)glyphCount))) {
+        end();
+        return false;
+    }
+    bitmapPos = file.position();
+    memset(slotOf, 0xFF, glyphCount);
+    clock = 0;
+
+    font.bitmap     = NULL; // Bitmaps come from getBitmap()
+    font.glyph      = glyphs;
+    font.first      = hdr[6];
+    font.last       = hdr[7];
+    font.yAdvance   = hdr[8];
+    font.flags      = hdr[5];
+    font.range      = nRanges ? ranges : NULL;
+    font.rangeCount = nRanges;
+    return true;
+}
+
+// Close the file and free the tables and cache
+void GFXfontFile::end(void) {
+    if(file) file.close();
+    free(glyphs);
+    free(glyphLen);
+    free(slotOf);
+    free(ranges);
+    free(cache);
+    free(slotGlyph);
+    free(slotUsed);
+    glyphs    = NULL;
+    ranges    = NULL;
+    cache     = NULL;
+    slotOf    = NULL;
+    glyphLen  = NULL;
+    slotGlyph = NULL;
+    slotUsed  = NULL;
+    nSlots    = 0;
+}
+
+// The loaded font, or NULL if none
+GFXfont *GFXfontFile::getFont(void) {
+    return glyphs ? &font : NULL;
+}
+
+// Glyph bitmap from the cache, read into the least recently used slot
+// if not there
+const uint8_t *GFXfontFile::getBitmap(GFXglyph *glyph, uint16_t *size) {
+    if(!glyphs || (glyph < glyphs) || (glyph >= &glyphs[glyphCount])) {
+        return NULL;
+    }
+    uint16_t g = glyph - glyphs;
+    uint8_t  s = slotOf[g];
+    *size = glyphLen[g];
+    if(!glyphLen[g]) return cache; // Blank, e.g. space
+
+    clock++;
+    if(s == 0xFF) {
+        s = 0;
+        for(uint8_t i=1; i<nSlots; i++) {
+            if(slotUsed[i] < slotUsed[s]) s = i;
+        }
+        if(slotUsed[s]) slotOf[slotGlyph[s]] = 0xFF; // Evict
+        slotUsed[s] = 0;
+        if(!file.seek(bitmapPos + glyph->bitmapOffset, fs::SeekSet) ||
+           (file.read(&cache[s * slotSize], glyphLen[g]) != glyphLen[g])) {
+            return NULL;
+        }
+        slotOf[g]    = s;
+        slotGlyph[s] = g;
+    }
+    slotUsed[s] = clock;
+    return &cache[s * slotSize];
+}
+
+#endif // ESP8266 || ESP32
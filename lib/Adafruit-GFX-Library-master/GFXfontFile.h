@@ -0,0 +1,71 @@
+#ifndef _GFXFONTFILE_H_
+#define _GFXFONTFILE_H_
+
+// Runtime-loadable font, read from a file system (e.g. SPIFFS) instead
+// of being compiled in.  The font header, glyph table and range table
+// are loaded into RAM (about 10 bytes per glyph); glyph bitmaps stay in
+// the file and are read as they're drawn, with the most recently used
+// ones kept in a small cache.  Use with setFontSource():
+//
+//   GFXfontFile font;
+//   if(font.begin(SPIFFS, "/fonts/FreeSans12pt7b.fnt")) {
+//       display.setFontSource(&font);
+//   }
+//
+// Files come from 'fontconvert -b'.  All values are little-endian:
+//
+//   0   'G' 'F' 'X' 'F'      Magic
+//   4   uint8_t   version    1
+//   5   uint8_t   flags      GFX_FONT_* bitmap format
+//   6   uint8_t   first      As in GFXfont
+//   7   uint8_t   last
+//   8   uint8_t   yAdvance
+//   9   uint8_t   reserved   0
+//   10  uint16_t  glyphCount
+//   12  uint16_t  rangeCount As in GFXfont, 0 if no range table
+//   14  uint16_t  maxBitmap  Largest glyph bitmap in bytes
+//   16  uint32_t  bitmapSize Total glyph bitmap bytes
+//   20  GFXrange  x rangeCount (first, last, glyphIndex: 6 bytes each)
+//   ..  glyphs    x glyphCount (9 bytes each): uint16_t bitmapOffset,
+//                 uint16_t bitmap length, then width, height, xAdvance,
+//                 xOffset, yOffset as in GFXglyph
+//   ..  bitmaps   bitmapSize bytes, offsets relative to this point
+//
+// ESP8266 and ESP32 only, as it needs their FS and RAM-readable
+// pgm_read_*().
+
+#if defined(ESP8266) || defined(ESP32)
+
+#include "Adafruit_GFX.h"
+#include <FS.h>
+
+#define GFX_FONT_FILE_VERSION 1
+
+class GFXfontFile : public GFXfontSource {
+ public:
+  GFXfontFile(void);
+  ~GFXfontFile(void);
+  boolean        begin(fs::FS &fs, const char *path, uint16_t cacheSize=1024);
+  void           end(void);
+  GFXfont       *getFont(void);
+  const uint8_t *getBitmap(GFXglyph *glyph, uint16_t *size);
+ private:
+  fs::File  file;
+  GFXfont   font;
+  GFXglyph *glyphs;
+  GFXrange *ranges;
+  uint8_t  *cache,     // nSlots * slotSize bytes
+           *slotOf,    // Cache slot holding each glyph, or 0xFF
+            nSlots;
+  uint16_t *glyphLen,  // Bitmap bytes of each glyph
+           *slotGlyph, // Glyph in each cache slot
+            glyphCount,
+            slotSize;  // Largest glyph bitmap
+  uint32_t *slotUsed,  // 'clock' at each slot's last use
+            clock,     // Incremented on each getBitmap()
+            bitmapPos; // File offset of the glyph bitmaps
+};
+
+#endif // ESP8266 || ESP32
+
+#endif // _GFXFONTFILE_H_
@@ -0,0 +1,227 @@
+/*
+Streaming BMP / PBM images, see GFXimageFile.h.
+*/
+
+#if defined(ESP8266) || defined(ESP32)
+
+#include "GFXimageFile.h"
+
+#define LE16(p) ((uint16_t)(p)[0] | ((uint16_t)(p)[1] << 8))
+#define LE32(p) ((uint32_t)LE16(p) | ((uint32_t)LE16((p) + 2) << 16))
+
+// Perceived brightness, 0-255
+#define LUMA(r, g, b) (((r) * 77 + (g) * 150 + (b) * 29) >> 8)
+
+// Rows collected per drawBitmap() call by draw()
+#ifndef GFX_IMAGE_BAND
+#define GFX_IMAGE_BAND 8
+#endif
+
+// Next number in a PBM header, skipping white space and comments.
+// -1 if there isn't one.
+static int32_t pbmNumber(fs::File &file) {
+    int     c;
+    int32_t n = -1;
+    do {
+        if((c = file.read()) == '#') {
+            while(((c = file.read()) >= 0) && (c != '\n'));
+        }
+    } while((c == ' ') || (c == '\t') || (c == '\r') || (c == '\n'));
+    while((c >= '0') && (c <= '9')) {
+        n = ((n < 0) ? 0 : n * 10) + c - '0';
+        if(n > 32767) return -1;
+        c = file.read();
+    }
+    // Exactly one white space character separates the header and data
+    return ((c == ' ') || (c == '\t') || (c == '\r') || (c == '\n')) ? n : -1;
+}
+
+GFXimageFile::GFXimageFile(void) {
+    w = h = 0;
+}
+
+// Open an image file and read its header.  Returns false if the file
+// is missing, isn't a supported format or is truncated.
+boolean GFXimageFile::begin(fs::FS &fs, const char *path) {
+    uint8_t hdr[34];
+
+    end();
+    if(!(file = fs.open(path, "r"))) return false;
+    if(file.read(hdr, 2) != 2) {
+        end();
+        return false;
+    }
+    if((hdr[0] == 'B') && (hdr[1] == 'M')) {
+        if(file.read(&hdr[2], 32) != 32) {
+            end();
+            return false;
+        }
+        uint32_t dib = LE32(&hdr[14]);
+        int32_t  bw  = (int32_t)LE32(&hdr[18]), bh = (int32_t)LE32(&hdr[22]);
+        bpp      = LE16(&hdr[28]);
+        bottomUp = (bh > 0);
+        if(bh < 0) bh = -bh;
+        if((dib < 40) || (LE16(&hdr[26]) != 1) || LE32(&hdr[30]) ||
+           ((bpp != 1) && (bpp != 24) && (bpp != 32)) ||
+           (bw <= 0) || (bw > 32767) || !bh || (bh > 32767)) {
+            end();              // Compressed, paletted colour or bogus
+            return false;
+        }
+        w       = bw;
+        h       = bh;
+        dataPos = LE32(&hdr[10]);
+        stride  = ((uint32_t)w * bpp + 31) / 32 * 4;
+        invert  = 0;
+        if(bpp == 1) { // Set bits are whichever palette entry is lighter
+            uint8_t pal[8];     // B, G, R, 0 for entries 0 and 1
+            if(!file.seek(14 + dib, fs::SeekSet) || (file.read(pal, 8) != 8)) {
+                end();
+                return false;
+            }
+            if(LUMA(pal[6], pal[5], pal[4]) < LUMA(pal[2], pal[1], pal[0])) {
+                invert = 0xFF;
+            }
+        }
+    } else if((hdr[0] == 'P') && (hdr[1] == '4')) {
+        int32_t pw = pbmNumber(file), ph = (pw > 0) ? pbmNumber(file) : -1;
+        if((pw <= 0) || (ph <= 0)) {
+            end();
+            return false;
+        }
+        w        = pw;
+        h        = ph;
+        bpp      = 1;
+        dataPos  = file.position();
+        stride   = (w + 7) / 8;
+        invert   = 0xFF;        // PBM 1 is black
+        bottomUp = false;
+    } else {
+        end();
+        return false;
+    }
+    uint32_t size = file.size(); // (stride * h can pass 32 bits)
+    if((dataPos > size) || ((size - dataPos) / stride < (uint32_t)h)) {
+        end();
+        return false;
+    }
+    nextPos = 0xFFFFFFFF;
+    return true;
+}
+
+void GFXimageFile::end(void) {
+    if(file) file.close();
+    w = h = 0;
+}
+
+int16_t GFXimageFile::width(void) const {
+    return w;
+}
+
+int16_t GFXimageFile::height(void) const {
+    return h;
+}
+
+// Read image row 'row' (0 = top) into 'bits' as a 1-bit, MSB-first row.
+// Colour pixels are read in chunks of a few dozen bytes, converted to
+// gray in 'gray' (a row of bytes) and dithered.  The row's padding is
+// read too, so rows stored top-down are read one after another with no
+// seek; bottom-up BMP rows need one each.
+boolean GFXimageFile::readRow(int16_t row, uint8_t *bits, uint8_t *gray,
+  GFXdither *dither) {
+    uint32_t pos   = dataPos +
+                     (uint32_t)(bottomUp ? h - 1 - row : row) * stride;
+    uint16_t bytes = (w + 7) / 8, i;
+    uint8_t  chunk[48], pad;
+    if((pos != nextPos) && !file.seek(pos, fs::SeekSet)) return false;
+    nextPos = 0xFFFFFFFF; // Unknown if this read fails
+
+    if(bpp == 1) {
+        if(file.read(bits, bytes) != bytes) return false;
+        if(invert) for(i=0; i<bytes; i++) bits[i] ^= 0xFF;
+        pad = stride - bytes;
+    } else {
+        uint8_t  n = bpp / 8, *p;
+        uint16_t x = 0, px;
+        while(x < w) {
+            px = sizeof(chunk) / n;
+            if(px > w - x) px = w - x;
+            if(file.read(chunk, px * n) != px * n) return false;
+            for(p=chunk; px--; p+=n) {
+                gray[x++] = LUMA(p[2], p[1], p[0]); // BGR(A)
+            }
+        }
+        dither->ditherRow(gray, bits);
+        pad = stride - (uint32_t)w * n;
+    }
+    if(pad && (file.read(chunk, pad) != pad)) return false; // 0-3 bytes
+    nextPos = pos + stride;
+    return true;
+}
+
+// Draw the image with its top-left corner at (x, y), light pixels in
+// 'color' and dark ones in 'bg', GFX_IMAGE_BAND rows per drawBitmap()
+// (a single address window on displays with a bulk drawBitmap()).
+// Rows below the display aren't read, nor are those above it unless
+// they need dithering.
+boolean GFXimageFile::draw(Adafruit_GFX *gfx, int16_t x, int16_t y,
+  uint16_t color, uint16_t bg, uint8_t mode) {
+    return render(gfx, NULL, gfx->width(), gfx->height(), x, y,
+      color, bg, mode);
+}
+
+// As draw(), but straight into a page-major frame buffer ('bufWidth'
+// bytes per 8-row page, LSB on top, as on SSD1306-style displays):
+// light pixels set, dark ones cleared.
+boolean GFXimageFile::drawPaged(uint8_t *buf, int16_t bufWidth,
+  int16_t bufHeight, int16_t x, int16_t y, uint8_t mode) {
+    return render(NULL, buf, bufWidth, bufHeight, x, y, 1, 0, mode);
+}
+
+boolean GFXimageFile::render(Adafruit_GFX *gfx, uint8_t *buf,
+  int16_t bufWidth, int16_t bufHeight, int16_t x, int16_t y,
+  uint16_t color, uint16_t bg, uint8_t mode) {
+    if(!file) return false;
+
+    int16_t   r    = (y < 0) ? -y : 0, last = bufHeight - y,
+              c0   = (x < 0) ? -x : 0, cEnd = bufWidth  - x, c,
+              rows = 0, top = 0; // Rows held in 'band', first one's y
+    uint16_t  bytes = (w + 7) / 8;
+    uint8_t   bandRows = gfx ? GFX_IMAGE_BAND : 1;
+    boolean   ok   = true, colour = (bpp > 1);
+    uint8_t  *band = (uint8_t *)malloc(bytes * bandRows), *bits,
+             *gray = colour ? (uint8_t *)malloc(w) : NULL;
+    if(!band && (bandRows > 1)) { // Short of RAM: a row at a time
+        band = (uint8_t *)malloc(bytes * (bandRows = 1));
+    }
+    GFXdither dither(colour ? w : 1, mode);
+    if(!band || (colour && !gray)) ok = false;
+    if(last > h) last = h;
+    if(cEnd > w) cEnd = w;
+    if(colour) r = 0; // GFXdither counts rows (and carries error) from 0
+
+    for(; ok && (r < last); r++) {
+        bits = &band[rows * bytes];
+        if(!(ok = readRow(r, bits, gray, &dither))) break;
+        if(y + r < 0) continue;
+        if(gfx) {
+            if(!rows) top = y + r;
+            if(++rows == bandRows) {
+                gfx->drawBitmap(x, top, band, w, rows, color, bg);
+                rows = 0;
+            }
+            continue;
+        }
+        uint8_t *page = &buf[((y + r) >> 3) * bufWidth],
+                 bit  = 1 << ((y + r) & 7);
+        for(c=c0; c<cEnd; c++) {
+            if(bits[c >> 3] & (0x80 >> (c & 7))) page[x + c] |=  bit;
+            else                                 page[x + c] &= ~bit;
+        }
+    }
+    if(rows) gfx->drawBitmap(x, top, band, w, rows, color, bg);
+    free(band);
+    free(gray);
+    return ok;
+}
+
+#endif // ESP8266 || ESP32
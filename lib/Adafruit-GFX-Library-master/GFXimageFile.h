@@ -0,0 +1,56 @@
+#ifndef _GFXIMAGEFILE_H_
+#define _GFXIMAGEFILE_H_
+
+// Monochrome image drawn straight from a file system (e.g. SPIFFS) a few
+// rows at a time, so RAM use depends on the width, not the height:
+// draw() holds GFX_IMAGE_BAND (8) 1-bit rows, or one if that won't fit,
+// drawPaged() one.  Colour images add a row of gray bytes and
+// GFXdither's rows (for GFX_DITHER_FLOYD 2 bytes per pixel more).
+// Reads uncompressed BMP (1, 24 or 32 bits per pixel, either row order)
+// and binary PBM ('P4').  Light pixels come out set, dark ones clear;
+// colour BMPs go through GFXdither (GFX_DITHER_* mode):
+//
+//   GFXimageFile img;
+//   if(img.begin(SPIFFS, "/logo.bmp")) {
+//       img.draw(&display, 0, 0, WHITE, BLACK);
+//       img.end();
+//   }
+//
+// ESP8266 and ESP32 only, as it needs their FS.
+
+#if defined(ESP8266) || defined(ESP32)
+
+#include "Adafruit_GFX.h"
+#include "GFXdither.h"
+#include <FS.h>
+
+class GFXimageFile {
+ public:
+  GFXimageFile(void);
+  boolean begin(fs::FS &fs, const char *path);
+  void    end(void);
+  int16_t width(void) const, height(void) const;
+  boolean
+    draw(Adafruit_GFX *gfx, int16_t x, int16_t y, uint16_t color,
+      uint16_t bg, uint8_t mode=GFX_DITHER_FLOYD),
+    drawPaged(uint8_t *buf, int16_t bufWidth, int16_t bufHeight,
+      int16_t x, int16_t y, uint8_t mode=GFX_DITHER_FLOYD);
+ private:
+  boolean
+    render(Adafruit_GFX *gfx, uint8_t *buf, int16_t bufWidth,
+      int16_t bufHeight, int16_t x, int16_t y, uint16_t color, uint16_t bg,
+      uint8_t mode),
+    readRow(int16_t row, uint8_t *bits, uint8_t *gray, GFXdither *dither);
+  fs::File file;
+  uint32_t dataPos, // File offset of the first row stored
+           stride,  // Bytes per row in the file
+           nextPos; // File offset after the last row read
+  int16_t  w, h;
+  uint8_t  bpp,     // 1, 24 or 32
+           invert;  // 0xFF if stored 1 bits are dark, else 0
+  boolean  bottomUp;
+};
+
+#endif // ESP8266 || ESP32
+
+#endif // _GFXIMAGEFILE_H_
@@ -0,0 +1,102 @@
+/*
+GFXmirror writes a page-major buffer as GFXA frames, each a delta from
+the last one written (see GFXanimation.h).
+*/
+
+#include "GFXmirror.h"
+
+#ifndef min
+#define min(a,b) (((a) < (b)) ? (a) : (b))
+#endif
+
+#define GFX_MIRROR_GAP 3 // Unchanged bytes bridged rather than starting a run
+
+GFXmirror::GFXmirror(void) {
+    last = NULL;
+}
+
+GFXmirror::~GFXmirror(void) {
+    end();
+}
+
+// Start a stream of frames from a 'width' x 'pages' buffer.  Allocates a
+// copy of the buffer to compare against; returns false if it can't.
+boolean GFXmirror::begin(uint8_t w, uint8_t p) {
+    end();
+    if(!w || !p || (p > 8) || !(last = (uint8_t *)malloc(w * p))) return false;
+    width = w;
+    pages = p;
+    key   = true;
+    return true;
+}
+
+void GFXmirror::end(void) {
+    if(last) free(last);
+    last = NULL;
+}
+
+// Make the next frame a keyframe, e.g. when the receiver missed one
+void GFXmirror::reset(void) {
+    key = true;
+}
+
+// Runs of bytes changed since the last frame, as in tools/anim_encode.js.
+// Returns the size of the delta frame, and writes it if 'out' isn't NULL
+// (updating the copy of the buffer to match).
+uint16_t GFXmirror::deltaRuns(const uint8_t *buf, Print *out) {
+    uint16_t size = 2, x, end, stop; // Type and end marker
+    if(out) out->write((uint8_t)GFX_ANIM_DELTA);
+    for(uint8_t p=0; p<pages; p++) {
+        const uint8_t *b = &buf[p * width];
+        uint8_t       *l = &last[p * width];
+        for(x=0; x<width; ) {
+            if(b[x] == l[x]) {
+                x++;
+                continue;
+            }
+            for(end=x+1, stop=x; (end < width) && (end - x < 255) &&
+              (end - stop <= GFX_MIRROR_GAP); end++) {
+                if(b[end] != l[end]) stop = end;
+            }
+            size += 4 + stop - x;
+            if(!out) {
+                x = stop + 1;
+                continue;
+            }
+            out->write(p);
+            out->write((uint8_t)x);
+            out->write((uint8_t)(stop - x + 1));
+            for(; x<=stop; x++) {
+                out->write(b[x] ^ l[x]);
+                l[x] = b[x];
+            }
+        }
+    }
+    if(out) out->write((uint8_t)0xFF);
+    return size;
+}
+
+// Size in bytes of the frame writeFrame() would write for 'buf' now, or
+// 0 if it's unchanged since the last frame (or begin() wasn't called)
+uint16_t GFXmirror::frameSize(const uint8_t *buf) {
+    if(!last) return 0;
+    uint16_t keySize = 1 + width * pages;
+    if(key) return keySize;
+    uint16_t size = deltaRuns(buf, NULL);
+    return (size == 2) ? 0 : min(size, keySize);
+}
+
+// Write the next frame for 'buf' to 'out', returning its size as for
+// frameSize(); nothing is written if that's 0.
+uint16_t GFXmirror::writeFrame(const uint8_t *buf, Print *out) {
+    uint16_t size = frameSize(buf), len = width * pages;
+    if(!size) return 0;
+    if(size > len) { // Keyframe
+        out->write((uint8_t)GFX_ANIM_KEY);
+        out->write(buf, len);
+        memcpy(last, buf, len);
+        key = false;
+        return size;
+    }
+    return deltaRuns(buf, out);
+}
@@ -0,0 +1,32 @@
+#ifndef _GFXMIRROR_H_
+#define _GFXMIRROR_H_
+
+#include "GFXanimation.h"
+
+// The other direction from GFXanimation: encodes a page-major buffer
+// that is being drawn into as a live stream of GFXA frames (without the
+// header), e.g. to mirror the display over the network.  Only the first
+// frame, and any after reset(), is a keyframe; the rest are deltas from
+// the last frame written, or keyframes where those would be no smaller:
+//
+//   if(mirror.frameSize(buf)) {     // 0 if nothing changed
+//       udp.beginPacket(ip, port);
+//       mirror.writeFrame(buf, &udp);
+//       udp.endPacket();
+//   }
+class GFXmirror {
+ public:
+  GFXmirror(void);
+  ~GFXmirror(void);
+  boolean  begin(uint8_t width, uint8_t pages);
+  void     end(void),
+           reset(void);
+  uint16_t frameSize(const uint8_t *buf),
+           writeFrame(const uint8_t *buf, Print *out);
+ private:
+  uint16_t deltaRuns(const uint8_t *buf, Print *out);
+  uint8_t  *last, width, pages; // Last frame written, NULL until begin()
+  boolean  key;
+};
+
+#endif // _GFXMIRROR_H_
@@ -0,0 +1,491 @@
+/*
+QR code encoder, see GFXqrcode.h.  Follows ISO/IEC 18004: byte mode
+data, Reed-Solomon error correction over GF(256) with log/antilog
+tables, and the mask with the lowest penalty score unless one is given.
+*/
+
+#include "GFXqrcode.h"
+
+#ifndef max
+#define max(a,b) (((a) > (b)) ? (a) : (b))
+#endif
+
+// Module bit 'i' of a row-major bitmap
+#define QR_BIT(buf, i) (((buf)[(i) >> 3] >> (7 - ((i) & 7))) & 1)
+
+// GF(256) antilog (twice over, so the sum of two logs needs no modulo)
+// and log tables, for the QR polynomial x^8 + x^4 + x^3 + x^2 + 1
+static const uint8_t PROGMEM gfExp[510] = {
+  0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1D, 0x3A, 0x74, 0xE8, 0xCD, 0x87, 0x13, 0x26,
+  0x4C, 0x98, 0x2D, 0x5A, 0xB4, 0x75, 0xEA, 0xC9, 0x8F, 0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0xC0,
+  0x9D, 0x27, 0x4E, 0x9C, 0x25, 0x4A, 0x94, 0x35, 0x6A, 0xD4, 0xB5, 0x77, 0xEE, 0xC1, 0x9F, 0x23,
+  0x46, 0x8C, 0x05, 0x0A, 0x14, 0x28, 0x50, 0xA0, 0x5D, 0xBA, 0x69, 0xD2, 0xB9, 0x6F, 0xDE, 0xA1,
+  0x5F, 0xBE, 0x61, 0xC2, 0x99, 0x2F, 0x5E, 0xBC, 0x65, 0xCA, 0x89, 0x0F, 0x1E, 0x3C, 0x78, 0xF0,
+  0xFD, 0xE7, 0xD3, 0xBB, 0x6B, 0xD6, 0xB1, 0x7F, 0xFE, 0xE1, 0xDF, 0xA3, 0x5B, 0xB6, 0x71, 0xE2,
+  0xD9, 0xAF, 0x43, 0x86, 0x11, 0x22, 0x44, 0x88, 0x0D, 0x1A, 0x34, 0x68, 0xD0, 0xBD, 0x67, 0xCE,
+  0x81, 0x1F, 0x3E, 0x7C, 0xF8, 0xED, 0xC7, 0x93, 0x3B, 0x76, 0xEC, 0xC5, 0x97, 0x33, 0x66, 0xCC,
+  0x85, 0x17, 0x2E, 0x5C, 0xB8, 0x6D, 0xDA, 0xA9, 0x4F, 0x9E, 0x21, 0x42, 0x84, 0x15, 0x2A, 0x54,
+  0xA8, 0x4D, 0x9A, 0x29, 0x52, 0xA4, 0x55, 0xAA, 0x49, 0x92, 0x39, 0x72, 0xE4, 0xD5, 0xB7, 0x73,
+  0xE6, 0xD1, 0xBF, 0x63, 0xC6, 0x91, 0x3F, 0x7E, 0xFC, 0xE5, 0xD7, 0xB3, 0x7B, 0xF6, 0xF1, 0xFF,
+  0xE3, 0xDB, 0xAB, 0x4B, 0x96, 0x31, 0x62, 0xC4, 0x95, 0x37, 0x6E, 0xDC, 0xA5, 0x57, 0xAE, 0x41,
+  0x82, 0x19, 0x32, 0x64, 0xC8, 0x8D, 0x07, 0x0E, 0x1C, 0x38, 0x70, 0xE0, 0xDD, 0xA7, 0x53, 0xA6,
+  0x51, 0xA2, 0x59, 0xB2, 0x79, 0xF2, 0xF9, 0xEF, 0xC3, 0x9B, 0x2B, 0x56, 0xAC, 0x45, 0x8A, 0x09,
+  0x12, 0x24, 0x48, 0x90, 0x3D, 0x7A, 0xF4, 0xF5, 0xF7, 0xF3, 0xFB, 0xEB, 0xCB, 0x8B, 0x0B, 0x16,
+  0x2C, 0x58, 0xB0, 0x7D, 0xFA, 0xE9, 0xCF, 0x83, 0x1B, 0x36, 0x6C, 0xD8, 0xAD, 0x47, 0x8E, 0x01,
+  0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1D, 0x3A, 0x74, 0xE8, 0xCD, 0x87, 0x13, 0x26, 0x4C,
+  0x98, 0x2D, 0x5A, 0xB4, 0x75, 0xEA, 0xC9, 0x8F, 0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0xC0, 0x9D,
+  0x27, 0x4E, 0x9C, 0x25, 0x4A, 0x94, 0x35, 0x6A, 0xD4, 0xB5, 0x77, 0xEE, 0xC1, 0x9F, 0x23, 0x46,
+  0x8C, 0x05, 0x0A, 0x14, 0x28, 0x50, 0xA0, 0x5D, 0xBA, 0x69, 0xD2, 0xB9, 0x6F, 0xDE, 0xA1, 0x5F,
+  0xBE, 0x61, 0xC2, 0x99, 0x2F, 0x5E, 0xBC, 0x65, 0xCA, 0x89, 0x0F, 0x1E, 0x3C, 0x78, 0xF0, 0xFD,
+  0xE7, 0xD3, 0xBB, 0x6B, 0xD6, 0xB1, 0x7F, 0xFE, 0xE1, 0xDF, 0xA3, 0x5B, 0xB6, 0x71, 0xE2, 0xD9,
+  0xAF, 0x43, 0x86, 0x11, 0x22, 0x44, 0x88, 0x0D, 0x1A, 0x34, 0x68, 0xD0, 0xBD, 0x67, 0xCE, 0x81,
+  0x1F, 0x3E, 0x7C, 0xF8, 0xED, 0xC7, 0x93, 0x3B, 0x76, 0xEC, 0xC5, 0x97, 0x33, 0x66, 0xCC, 0x85,
+  0x17, 0x2E, 0x5C, 0xB8, 0x6D, 0xDA, 0xA9, 0x4F, 0x9E, 0x21, 0x42, 0x84, 0x15, 0x2A, 0x54, 0xA8,
+  0x4D, 0x9A, 0x29, 0x52, 0xA4, 0x55, 0xAA, 0x49, 0x92, 0x39, 0x72, 0xE4, 0xD5, 0xB7, 0x73, 0xE6,
+  0xD1, 0xBF, 0x63, 0xC6, 0x91, 0x3F, 0x7E, 0xFC, 0xE5, 0xD7, 0xB3, 0x7B, 0xF6, 0xF1, 0xFF, 0xE3,
+  0xDB, 0xAB, 0x4B, 0x96, 0x31, 0x62, 0xC4, 0x95, 0x37, 0x6E, 0xDC, 0xA5, 0x57, 0xAE, 0x41, 0x82,
+  0x19, 0x32, 0x64, 0xC8, 0x8D, 0x07, 0x0E, 0x1C, 0x38, 0x70, 0xE0, 0xDD, 0xA7, 0x53, 0xA6, 0x51,
+  0xA2, 0x59, 0xB2, 0x79, 0xF2, 0xF9, 0xEF, 0xC3, 0x9B, 0x2B, 0x56, 0xAC, 0x45, 0x8A, 0x09, 0x12,
+  0x24, 0x48, 0x90, 0x3D, 0x7A, 0xF4, 0xF5, 0xF7, 0xF3, 0xFB, 0xEB, 0xCB, 0x8B, 0x0B, 0x16, 0x2C,
+  0x58, 0xB0, 0x7D, 0xFA, 0xE9, 0xCF, 0x83, 0x1B, 0x36, 0x6C, 0xD8, 0xAD, 0x47, 0x8E };
+
+static const uint8_t PROGMEM gfLog[256] = {
+  0x00, 0x00, 0x01, 0x19, 0x02, 0x32, 0x1A, 0xC6, 0x03, 0xDF, 0x33, 0xEE, 0x1B, 0x68, 0xC7, 0x4B,
+  0x04, 0x64, 0xE0, 0x0E, 0x34, 0x8D, 0xEF, 0x81, 0x1C, 0xC1, 0x69, 0xF8, 0xC8, 0x08, 0x4C, 0x71,
+  0x05, 0x8A, 0x65, 0x2F, 0xE1, 0x24, 0x0F, 0x21, 0x35, 0x93, 0x8E, 0xDA, 0xF0, 0x12, 0x82, 0x45,
+  0x1D, 0xB5, 0xC2, 0x7D, 0x6A, 0x27, 0xF9, 0xB9, 0xC9, 0x9A, 0x09, 0x78, 0x4D, 0xE4, 0x72, 0xA6,
+  0x06, 0xBF, 0x8B, 0x62, 0x66, 0xDD, 0x30, 0xFD, 0xE2, 0x98, 0x25, 0xB3, 0x10, 0x91, 0x22, 0x88,
+  0x36, 0xD0, 0x94, 0xCE, 0x8F, 0x96, 0xDB, 0xBD, 0xF1, 0xD2, 0x13, 0x5C, 0x83, 0x38, 0x46, 0x40,
+  0x1E, 0x42, 0xB6, 0xA3, 0xC3, 0x48, 0x7E, 0x6E, 0x6B, 0x3A, 0x28, 0x54, 0xFA, 0x85, 0xBA, 0x3D,
+  0xCA, 0x5E, 0x9B, 0x9F, 0x0A, 0x15, 0x79, 0x2B, 0x4E, 0xD4, 0xE5, 0xAC, 0x73, 0xF3, 0xA7, 0x57,
+  0x07, 0x70, 0xC0, 0xF7, 0x8C, 0x80, 0x63, 0x0D, 0x67, 0x4A, 0xDE, 0xED, 0x31, 0xC5, 0xFE, 0x18,
+  0xE3, 0xA5, 0x99, 0x77, 0x26, 0xB8, 0xB4, 0x7C, 0x11, 0x44, 0x92, 0xD9, 0x23, 0x20, 0x89, 0x2E,
+  0x37, 0x3F, 0xD1, 0x5B, 0x95, 0xBC, 0xCF, 0xCD, 0x90, 0x87, 0x97, 0xB2, 0xDC, 0xFC, 0xBE, 0x61,
+  0xF2, 0x56, 0xD3, 0xAB, 0x14, 0x2A, 0x5D, 0x9E, 0x84, 0x3C, 0x39, 0x53, 0x47, 0x6D, 0x41, 0xA2,
+  0x1F, 0x2D, 0x43, 0xD8, 0xB7, 0x7B, 0xA4, 0x76, 0xC4, 0x17, 0x49, 0xEC, 0x7F, 0x0C, 0x6F, 0xF6,
+  0x6C, 0xA1, 0x3B, 0x52, 0x29, 0x9D, 0x55, 0xAA, 0xFB, 0x60, 0x86, 0xB1, 0xBB, 0xCC, 0x3E, 0x5A,
+  0xCB, 0x59, 0x5F, 0xB0, 0x9C, 0xA9, 0xA0, 0x51, 0x0B, 0xF5, 0x16, 0xEB, 0x7A, 0x75, 0x2C, 0xD7,
+  0x4F, 0xAE, 0xD5, 0xE9, 0xE6, 0xE7, 0xAD, 0xE8, 0x74, 0xD6, 0xF4, 0xEA, 0xA8, 0x50, 0x58, 0xAF };
+
+// ECC codewords per block, and number of blocks, for each ECC level
+// (GFX_QR_ECC_* order) and version 1-40
+static const uint8_t PROGMEM eccPerBlock[4][40] = {
+  {  7, 10, 15, 20, 26, 18, 20, 24, 30, 18, 20, 24, 26, 30, 22, 24, 28, 30, 28, 28,
+    28, 28, 30, 30, 26, 28, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30 },
+  { 10, 16, 26, 18, 24, 16, 18, 22, 22, 26, 30, 22, 22, 24, 24, 28, 28, 26, 26, 26,
+    26, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28, 28 },
+  { 13, 22, 18, 26, 18, 24, 18, 22, 20, 24, 28, 26, 24, 20, 30, 24, 28, 28, 26, 30,
+    28, 30, 30, 30, 30, 28, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30 },
+  { 17, 28, 22, 16, 22, 28, 26, 26, 24, 28, 24, 28, 22, 24, 24, 30, 28, 28, 26, 28,
+    30, 24, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30, 30 } };
+
+static const uint8_t PROGMEM eccBlocks[4][40] = {
+  {  1,  1,  1,  1,  1,  2,  2,  2,  2,  4,  4,  4,  4,  4,  6,  6,  6,  6,  7,  8,
+     8,  9,  9, 10, 12, 12, 12, 13, 14, 15, 16, 17, 18, 19, 19, 20, 21, 22, 24, 25 },
+  {  1,  1,  1,  2,  2,  4,  4,  4,  5,  5,  5,  8,  9,  9, 10, 10, 11, 13, 14, 16,
+    17, 17, 18, 20, 21, 23, 25, 26, 28, 29, 31, 33, 35, 37, 38, 40, 43, 45, 47, 49 },
+  {  1,  1,  2,  2,  4,  4,  6,  6,  8,  8,  8, 10, 12, 16, 12, 17, 16, 18, 21, 20,
+    23, 23, 25, 27, 29, 34, 34, 35, 38, 40, 43, 45, 48, 51, 53, 56, 59, 62, 65, 68 },
+  {  1,  1,  2,  4,  4,  4,  5,  6,  8,  8, 11, 11, 16, 16, 18, 16, 19, 21, 25, 25,
+    25, 34, 30, 32, 35, 37, 40, 42, 45, 48, 51, 54, 57, 60, 63, 66, 70, 74, 77, 81 } };
+
+// Codewords (data and ECC) a version holds
+static uint16_t rawCodewords(uint8_t ver) {
+    uint32_t n = (16 * (uint32_t)ver + 128) * ver + 64;
+    if(ver >= 2) {
+        uint8_t align = ver / 7 + 2;
+        n -= (25 * align - 10) * align - 55;
+        if(ver >= 7) n -= 36;
+    }
+    return n / 8;
+}
+
+// Append the 'n' low bits of 'v' to a zeroed bit buffer
+static void putBits(uint8_t *buf, uint16_t *pos, uint16_t v, uint8_t n) {
+    while(n--) {
+        if((v >> n) & 1) buf[*pos >> 3] |= 0x80 >> (*pos & 7);
+        (*pos)++;
+    }
+}
+
+GFXqrcode::GFXqrcode(void) {
+    size = 0;
+}
+
+// Encode a string (or 'len' bytes of data) at the given ECC level, in
+// the smallest version it fits.  Returns false if it's too long for
+// GFX_QR_MAX_VERSION.
+boolean GFXqrcode::encode(const char *text, uint8_t e, uint8_t m) {
+    return encode((const uint8_t *)text, strlen(text), e, m);
+}
+
+boolean GFXqrcode::encode(const uint8_t *data, uint16_t len, uint8_t e,
+  uint8_t m) {
+    uint16_t dataLen, pos = 0, i;
+    uint8_t  blocks, eccLen, pad;
+
+    size = 0;
+    if((e > GFX_QR_ECC_HIGH) || ((m > 7) && (m != GFX_QR_MASK_AUTO))) {
+        return false;
+    }
+    for(version=1; ; version++) {
+        if(version > GFX_QR_MAX_VERSION) return false;
+        blocks  = pgm_read_byte(&eccBlocks[e][version - 1]);
+        eccLen  = pgm_read_byte(&eccPerBlock[e][version - 1]);
+        dataLen = rawCodewords(version) - blocks * eccLen;
+        // Mode, length (8 or 16 bits) and data bits
+        if(4 + ((version < 10) ? 8 : 16) + 8 * (uint32_t)len <=
+           8 * (uint32_t)dataLen) break;
+    }
+    ecc  = e;
+    size = version * 4 + 17;
+
+    // Data codewords: byte mode, length and data, then a terminator of
+    // up to 4 zero bits, zeros to a byte boundary and pad bytes
+    memset(codewords, 0, dataLen);
+    putBits(codewords, &pos, 0x4, 4);
+    putBits(codewords, &pos, len, (version < 10) ? 8 : 16);
+    for(i=0; i<len; i++) putBits(codewords, &pos, data[i], 8);
+    for(i=(pos + 7) / 8, pad=0xEC; i<dataLen; i++, pad^=0xEC^0x11) {
+        codewords[i] = pad;
+    }
+    addEcc(dataLen, blocks, eccLen);
+
+    memset(modules,  0, (size * size + 7) / 8);
+    memset(function, 0, (size * size + 7) / 8);
+    drawFunctionPatterns();
+    drawCodewords(dataLen, blocks, eccLen);
+    if(m == GFX_QR_MASK_AUTO) {
+        uint32_t best = 0xFFFFFFFF, p;
+        for(i=0; i<8; i++) {
+            applyMask(i);
+            drawFormatBits(i);
+            if((p = penalty()) < best) {
+                best = p;
+                m    = i;
+            }
+            applyMask(i); // XOR again to undo
+        }
+    }
+    applyMask(m);
+    drawFormatBits(m);
+    mask = m;
+    return true;
+}
+
+// Split the data codewords into blocks and append each block's ECC
+void GFXqrcode::addEcc(uint16_t dataLen, uint8_t blocks, uint8_t eccLen) {
+    uint8_t gen[30], root = 0, i, j; // Generator polynomial, as logs
+
+    // (x - a^0)(x - a^1)...(x - a^(eccLen-1)), leading 1 left out.
+    // Coefficients are built as values, then turned into logs; 0xFF
+    // stands for a zero coefficient (log undefined).
+    memset(gen, 0, eccLen);
+    gen[eccLen - 1] = 1;
+    for(i=0; i<eccLen; i++, root++) {
+        for(j=0; j<eccLen; j++) {
+            if(gen[j]) {
+                gen[j] = pgm_read_byte(&gfExp[pgm_read_byte(&gfLog[gen[j]]) +
+                                              root]);
+            }
+            if(j + 1 < eccLen) gen[j] ^= gen[j + 1];
+        }
+    }
+    for(j=0; j<eccLen; j++) {
+        gen[j] = gen[j] ? pgm_read_byte(&gfLog[gen[j]]) : 0xFF;
+    }
+
+    uint16_t       raw      = dataLen + blocks * eccLen,
+                   shortLen = raw / blocks,       // Shorter blocks' length
+                   numShort = blocks - raw % blocks, n;
+    const uint8_t *d        = codewords;
+    for(i=0; i<blocks; i++) {
+        uint8_t *rem = &codewords[dataLen + i * eccLen];
+        memset(rem, 0, eccLen);
+        for(n = shortLen - eccLen + (i >= numShort); n--; ) {
+            uint8_t f = *d++ ^ rem[0];
+            memmove(rem, rem + 1, eccLen - 1);
+            rem[eccLen - 1] = 0;
+            if(!f) continue;
+            uint8_t lf = pgm_read_byte(&gfLog[f]);
+            for(j=0; j<eccLen; j++) {
+                if(gen[j] != 0xFF) rem[j] ^= pgm_read_byte(&gfExp[lf + gen[j]]);
+            }
+        }
+    }
+}
+
+void GFXqrcode::setModule(uint8_t x, uint8_t y, boolean dark) {
+    uint16_t i = y * size + x;
+    if(dark) modules[i >> 3] |=  (0x80 >> (i & 7));
+    else     modules[i >> 3] &= ~(0x80 >> (i & 7));
+}
+
+void GFXqrcode::setFunction(uint8_t x, uint8_t y, boolean dark) {
+    uint16_t i = y * size + x;
+    setModule(x, y, dark);
+    function[i >> 3] |= 0x80 >> (i & 7);
+}
+
+// Color of a module (true = dark), once encode() has succeeded
+boolean GFXqrcode::getModule(uint8_t x, uint8_t y) const {
+    uint16_t i = y * size + x;
+    return (x < size) && (y < size) && QR_BIT(modules, i);
+}
+
+uint8_t GFXqrcode::getSize(void) const {
+    return size;
+}
+
+uint8_t GFXqrcode::getVersion(void) const {
+    return size ? version : 0;
+}
+
+uint8_t GFXqrcode::getMask(void) const {
+    return mask;
+}
+
+// Timing, finder and alignment patterns, and version information;
+// format bits are reserved here and drawn with the mask
+void GFXqrcode::drawFunctionPatterns(void) {
+    int8_t  dx, dy, d;
+    uint8_t i, j;
+
+    for(i=0; i<size; i++) {
+        setFunction(6, i, !(i & 1));
+        setFunction(i, 6, !(i & 1));
+    }
+    for(i=0; i<3; i++) { // Finders and their separators
+        uint8_t cx = (i == 1) ? size - 4 : 3, cy = (i == 2) ? size - 4 : 3;
+        for(dy=-4; dy<=4; dy++) {
+            for(dx=-4; dx<=4; dx++) {
+                if((cx + dx < 0) || (cx + dx >= size) ||
+                   (cy + dy < 0) || (cy + dy >= size)) continue;
+                d = max(abs(dx), abs(dy));
+                setFunction(cx + dx, cy + dy, (d != 2) && (d != 4));
+            }
+        }
+    }
+    if(version > 1) {
+        uint8_t n    = version / 7 + 2, pos[7],
+                step = (version * 8 + n * 3 + 5) / (n * 4 - 4) * 2;
+        pos[0] = 6;
+        for(i=n-1, j=size-7; i>=1; i--, j-=step) pos[i] = j;
+        for(i=0; i<n; i++) {
+            for(j=0; j<n; j++) {
+                if((!i && !j) || (!i && (j == n - 1)) || ((i == n - 1) && !j)) {
+                    continue; // Finder corners
+                }
+                for(dy=-2; dy<=2; dy++) {
+                    for(dx=-2; dx<=2; dx++) {
+                        setFunction(pos[i] + dx, pos[j] + dy,
+                          max(abs(dx), abs(dy)) != 1);
+                    }
+                }
+            }
+        }
+    }
+    drawFormatBits(0); // Reserve
+    if(version >= 7) {
+        uint32_t rem = version, bits;
+        for(i=0; i<12; i++) rem = (rem << 1) ^ ((rem >> 11) * 0x1F25);
+        bits = ((uint32_t)version << 12) | rem;
+        for(i=0; i<18; i++) {
+            boolean b = (bits >> i) & 1;
+            uint8_t a = size - 11 + i % 3;
+            setFunction(a, i / 3, b);
+            setFunction(i / 3, a, b);
+        }
+    }
+}
+
+// 15-bit ECC level and mask information, both copies, and the dark
+// module beside the lower-left finder
+void GFXqrcode::drawFormatBits(uint8_t m) {
+    static const uint8_t PROGMEM level[4] = { 1, 0, 3, 2 };
+    uint16_t data = (pgm_read_byte(&level[ecc]) << 3) | m, rem = data, bits;
+    uint8_t  i;
+    for(i=0; i<10; i++) rem = (rem << 1) ^ ((rem >> 9) * 0x537);
+    bits = ((data << 10) | rem) ^ 0x5412;
+
+    for(i=0; i<=5; i++) setFunction(8, i, (bits >> i) & 1);
+    setFunction(8, 7, (bits >> 6) & 1);
+    setFunction(8, 8, (bits >> 7) & 1);
+    setFunction(7, 8, (bits >> 8) & 1);
+    for(i=9; i<15; i++) setFunction(14 - i, 8, (bits >> i) & 1);
+    for(i=0; i<8; i++)  setFunction(size - 1 - i, 8, (bits >> i) & 1);
+    for(i=8; i<15; i++) setFunction(8, size - 15 + i, (bits >> i) & 1);
+    setFunction(8, size - 8, true);
+}
+
+// Place the codewords, interleaved block by block, in the zigzag
+// order: up and down two-module columns from the right, skipping
+// function modules.  Bytes are fetched from the blocks as they're needed.
+void GFXqrcode::drawCodewords(uint16_t dataLen, uint8_t blocks,
+  uint8_t eccLen) {
+    uint16_t raw      = dataLen + blocks * eccLen,
+             shortLen = raw / blocks, numShort = blocks - raw % blocks,
+             i = 0, left = raw, k, dl;
+    uint8_t  b = 0, byte = 0, bits = 0, vert, x, y;
+    int16_t  right;
+
+    for(right=size-1; right>=1; right-=2) {
+        if(right == 6) right = 5; // Skip the vertical timing pattern
+        boolean up = !((right + 1) & 2);
+        for(vert=0; vert<size; vert++) {
+            y = up ? size - 1 - vert : vert;
+            for(uint8_t j=0; j<2; j++) {
+                x = right - j;
+                if(QR_BIT(function, y * size + x)) continue;
+                if(!bits) {
+                    if(!left) return; // Remainder bits stay light
+                    // Next interleaved codeword: byte 'i' of block 'b'.
+                    // Short blocks have no data byte at their last data
+                    // index, so skip them there.
+                    for(;;) {
+                        dl = shortLen - eccLen + (b >= numShort);
+                        k  = i;
+                        if(b < numShort) {
+                            if(i == dl) k = 0xFFFF;
+                            else if(i > dl) k = i - 1;
+                        }
+                        uint8_t blk = b;
+                        if(++b == blocks) {
+                            b = 0;
+                            i++;
+                        }
+                        if(k == 0xFFFF) continue;
+                        byte = (k < dl) ?
+                          codewords[blk * (shortLen - eccLen) +
+                            ((blk > numShort) ? blk - numShort : 0) + k] :
+                          codewords[dataLen + blk * eccLen + k - dl];
+                        break;
+                    }
+                    bits = 8;
+                    left--;
+                }
+                if((byte >> --bits) & 1) setModule(x, y, true);
+            }
+        }
+    }
+}
+
+// XOR a mask pattern over the non-function modules
+void GFXqrcode::applyMask(uint8_t m) {
+    uint8_t  x, y;
+    uint16_t i = 0;
+    for(y=0; y<size; y++) {
+        for(x=0; x<size; x++, i++) {
+            if(QR_BIT(function, i)) continue;
+            boolean inv;
+            switch(m) {
+              case 0:  inv = !((x + y) % 2);                       break;
+              case 1:  inv = !(y % 2);                             break;
+              case 2:  inv = !(x % 3);                             break;
+              case 3:  inv = !((x + y) % 3);                       break;
+              case 4:  inv = !((x / 3 + y / 2) % 2);               break;
+              case 5:  inv = !(x * y % 2 + x * y % 3);             break;
+              case 6:  inv = !((x * y % 2 + x * y % 3) % 2);       break;
+              default: inv = !(((x + y) % 2 + x * y % 3) % 2);     break;
+            }
+            if(inv) modules[i >> 3] ^= 0x80 >> (i & 7);
+        }
+    }
+}
+
+// Mask penalty score: long runs, 2x2 blocks, finder-like patterns and
+// dark/light imbalance
+uint32_t GFXqrcode::penalty(void) {
+    uint32_t p = 0, dark = 0, total = (uint32_t)size * size;
+    uint8_t  a, b, run, c, prev;
+    uint16_t pattern;
+
+    for(uint8_t dir=0; dir<2; dir++) {   // Rows, then columns
+        for(a=0; a<size; a++) {
+            run     = 0;
+            prev    = 2;
+            pattern = 0; // Last 11 modules, newest in bit 0
+            // Scan from 4 modules before the line to 4 after it, taking
+            // those as light (the quiet zone), so that finder-like
+            // patterns touching either edge of the symbol are counted
+            for(b=0; b<size+8; b++) {
+                c = 0;
+                if((b >= 4) && (b < size+4)) {
+                    uint8_t m = b - 4;
+                    c = QR_BIT(modules, dir ? m * size + a : a * size + m);
+                    if(c == prev) {
+                        if(++run == 5) p += 3;
+                        else if(run > 5) p++;
+                    } else {
+                        prev = c;
+                        run  = 1;
+                    }
+                    dark += c;
+                }
+                // 1011101 with 4 light modules before it, or after it
+                // (40 each, so 80 with both)
+                pattern = ((pattern << 1) | c) & 0x7FF;
+                if((pattern == 0x05D) || (pattern == 0x5D0)) p += 40;
+            }
+        }
+    }
+    dark /= 2; // Counted in both directions
+    for(a=0; a<size-1; a++) {
+        for(b=0; b<size-1; b++) {
+            uint16_t i = a * size + b;
+            c = QR_BIT(modules, i);
+            if((c == QR_BIT(modules, i + 1)) &&
+               (c == QR_BIT(modules, i + size)) &&
+               (c == QR_BIT(modules, i + size + 1))) p += 3;
+        }
+    }
+    // 10 points for each full 5% of deviation from half dark
+    uint32_t diff = (dark * 20 > total * 10) ? dark * 20 - total * 10 :
+                                               total * 10 - dark * 20;
+    p += ((diff + total - 1) / total - 1) * 10;
+    return p;
+}
+
+// Draw the symbol with a 'border' modules wide quiet zone, 'scale'
+// pixels per module, its top-left corner (with border) at (x, y)
+void GFXqrcode::draw(Adafruit_GFX *gfx, int16_t x, int16_t y, uint8_t scale,
+  uint16_t dark, uint16_t light, uint8_t border) {
+    if(!size || !scale) return;
+    int16_t full = (size + 2 * border) * scale, r, c, c0;
+    gfx->startWrite();
+    gfx->writeFillRect(x, y, full, full, light);
+    x += border * scale;
+    y += border * scale;
+    for(r=0; r<size; r++) {     // Horizontal runs of dark modules
+        for(c=0; c<size; ) {
+            if(!getModule(c, r)) {
+                c++;
+                continue;
+            }
+            for(c0=c; (c<size) && getModule(c, r); c++);
+            gfx->writeFillRect(x + c0 * scale, y + r * scale,
+              (c - c0) * scale, scale, dark);
+        }
+    }
+    gfx->endWrite();
+}
+
+// Same, into a page-major frame buffer ('bufWidth' bytes per 8-row page,
+// LSB on top, as on SSD1306-style displays).  Light modules and the
+// border are set (lit) and dark modules cleared, as scanners expect.
+void GFXqrcode::drawPaged(uint8_t *buf, int16_t bufWidth, int16_t bufHeight,
+  int16_t x, int16_t y, uint8_t scale, uint8_t border) {
+    if(!size || !scale) return;
+    int16_t full = (size + 2 * border) * scale, i, j, px, py;
+    for(j=0; j<full; j++) {
+        if(((py = y + j) < 0) || (py >= bufHeight)) continue;
+        uint8_t *page = &buf[(py >> 3) * bufWidth], bit = 1 << (py & 7);
+        int16_t  my   = j / scale - border;
+        for(i=0; i<full; i++) {
+            if(((px = x + i) < 0) || (px >= bufWidth)) continue;
+            int16_t mx = i / scale - border;
+            if((mx >= 0) && (my >= 0) && getModule(mx, my)) page[px] &= ~bit;
+            else                                            page[px] |=  bit;
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef _GFXQRCODE_H_
+#define _GFXQRCODE_H_
+
+// QR code encoder (byte mode, versions 1 to GFX_QR_MAX_VERSION).  The
+// symbol is built in the object's own fixed buffers, without the heap,
+// so make it static or global rather than a local on the stack:
+//
+//   static GFXqrcode qr;
+//   if(qr.encode("WIFI:S:esp8266-1234;;")) {
+//       qr.draw(&display, 0, 0, 1, BLACK, WHITE, 1);
+//   }
+//
+// Version 3 (29 modules) is the largest that fits a 128x32 OLED at one
+// pixel per module with a 1-module border; 5 (37) fits 128x64.
+
+#include "Adafruit_GFX.h"
+
+#ifndef GFX_QR_MAX_VERSION
+#define GFX_QR_MAX_VERSION 10 // Up to 57x57 modules, 271 bytes at ECC L
+#endif
+
+#define GFX_QR_ECC_LOW      0 // Recovers ~7% of codewords
+#define GFX_QR_ECC_MEDIUM   1 // ~15%
+#define GFX_QR_ECC_QUARTILE 2 // ~25%
+#define GFX_QR_ECC_HIGH     3 // ~30%
+#define GFX_QR_MASK_AUTO    0xFF
+
+#define GFX_QR_MAX_SIZE     (GFX_QR_MAX_VERSION * 4 + 17)
+#define GFX_QR_MAX_BYTES    ((GFX_QR_MAX_SIZE * GFX_QR_MAX_SIZE + 7) / 8)
+
+class GFXqrcode {
+ public:
+  GFXqrcode(void);
+  boolean
+    encode(const char *text, uint8_t ecc=GFX_QR_ECC_MEDIUM,
+      uint8_t mask=GFX_QR_MASK_AUTO),
+    encode(const uint8_t *data, uint16_t len, uint8_t ecc=GFX_QR_ECC_MEDIUM,
+      uint8_t mask=GFX_QR_MASK_AUTO),
+    getModule(uint8_t x, uint8_t y) const;
+  uint8_t
+    getSize(void) const,
+    getVersion(void) const,
+    getMask(void) const;
+  void
+    draw(Adafruit_GFX *gfx, int16_t x, int16_t y, uint8_t scale,
+      uint16_t dark, uint16_t light, uint8_t border=0),
+    drawPaged(uint8_t *buf, int16_t bufWidth, int16_t bufHeight,
+      int16_t x, int16_t y, uint8_t scale, uint8_t border=0);
+
+ private:
+  void
+    setModule(uint8_t x, uint8_t y, boolean dark),
+    setFunction(uint8_t x, uint8_t y, boolean dark),
+    drawFunctionPatterns(void),
+    drawFormatBits(uint8_t mask),
+    drawCodewords(uint16_t dataLen, uint8_t blocks, uint8_t eccLen),
+    applyMask(uint8_t mask),
+    addEcc(uint16_t dataLen, uint8_t blocks, uint8_t eccLen);
+  uint32_t
+    penalty(void);
+  uint8_t
+    modules[GFX_QR_MAX_BYTES],   // Row-major bits, MSB first; 1 = dark
+    function[GFX_QR_MAX_BYTES],  // Set for finder, timing etc. modules
+    codewords[GFX_QR_MAX_BYTES], // Data, then ECC
+    size,                        // 0 if nothing encoded
+    version,
+    ecc,
+    mask;
+};
+
+#endif // _GFXQRCODE_H_
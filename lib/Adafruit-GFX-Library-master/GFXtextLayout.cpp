@@ -0,0 +1,167 @@
+/*
+GFXtextLayout breaks text into lines at spaces (or mid-word, if a word
+is wider than the layout), and at newlines, keeping the offset of the
+start of each line.  Up to GFX_LAYOUT_LINES lines are kept; text past
+that is left out.
+*/
+
+#include "GFXtextLayout.h"
+
+GFXtextLayout::GFXtextLayout(void) {
+    _gfx    = NULL;
+    _str    = NULL;
+    _text   = NULL;
+    _len    = 0;
+    _room   = 0;
+    _lines  = 0;
+    _width  = 0;
+    _copied = false;
+}
+
+GFXtextLayout::~GFXtextLayout(void) {
+    free(_text);
+}
+
+// Lay out a string 'width' pixels wide in gfx's current font and size,
+// returning the number of lines.  The string must stay in place (and
+// unchanged) for drawLines().
+uint16_t GFXtextLayout::layout(Adafruit_GFX *gfx, const char *str,
+  int16_t width) {
+    return breakLines(gfx, str, false, width);
+}
+
+uint16_t GFXtextLayout::layout(Adafruit_GFX *gfx,
+  const __FlashStringHelper *str, int16_t width) {
+    return breakLines(gfx, (const char *)str, true, width);
+}
+
+uint16_t GFXtextLayout::breakLines(Adafruit_GFX *gfx, const char *str,
+  boolean pgm, int16_t width) {
+    GFXfont    *font = gfx->gfxFont;
+    uint8_t     size = gfx->textsize, c, left = 0;
+    uint32_t    len  = 0;          // String length + 1, once counted
+    boolean     same = _copied;
+
+    do { // The copy's NUL ends the comparison before it can overrun
+        c = pgm ? pgm_read_byte(&str[len]) : str[len];
+        if(same && (_text[len] != (char)c)) same = false;
+        len++;
+    } while(c);
+    _str = str; // Same text elsewhere lays out the same, but draw from here
+    _pgm = pgm;
+    if(same && (_gfx == gfx) && (_font == font) && (_size == size) &&
+       (_width == width)) {
+        return _lines;
+    }
+    if(len > 0xFFFF) len = 0xFFFF; // Lay out as much as _start[] can hold
+    _copied = false; // Not cached unless the copy below fits
+    if(len > _room) {
+        char *t = (char *)realloc(_text, len);
+        if(t) {
+            _text = t;
+            _room = len;
+        }
+    }
+    if(len <= _room) {
+        if(pgm) memcpy_P(_text, str, len);
+        else    memcpy(_text, str, len);
+        _text[len - 1] = '\0';
+        _copied = true;
+    }
+    _gfx   = gfx;
+    _width = width;
+    _len   = len;
+    _font  = font;
+    _size  = size;
+
+    boolean  utf8  = font && pgm_read_word(&font->rangeCount);
+    uint16_t n     = _len - 1, line = 0, i, code = 0, cp,
+             start = 0, // Offset of the current character
+             brk   = 0; // Offset after the line's last space
+    int16_t  x     = 0, // Width of the line so far
+             xBrk  = 0; // ...and up to brk
+    _start[0] = 0;
+    for(i=0; i<n; i++) {
+        c = pgm ? pgm_read_byte(&str[i]) : str[i];
+        if(!left) start = i;
+        if(c == '\n') {
+            if(line == GFX_LAYOUT_LINES - 1) break;
+            _start[++line] = i + 1;
+            x = 0;
+            continue;
+        }
+        if(c == '\r') continue;
+        cp = utf8 ? Adafruit_GFX::utf8Decode(c, &code, &left) : c;
+        if(cp == 0xFFFF) continue;
+
+        int16_t adv = 6;
+        if(font) {
+            GFXglyph *glyph = gfx->getGlyph(cp);
+            adv = glyph ? (uint8_t)pgm_read_byte(&glyph->xAdvance) : 0;
+        }
+        adv *= size;
+        if(cp == ' ') {        // Spaces may hang past the edge
+            x   += adv;
+            brk  = i + 1;
+            xBrk = x;
+            continue;
+        }
+        if((x + adv > _width) && (x > 0)) {
+            if(line == GFX_LAYOUT_LINES - 1) {
+                i = start;
+                break;
+            }
+            if(brk > _start[line]) { // Wrap the word after the last space
+                _start[++line] = brk;
+                x -= xBrk;
+            }
+            if((x + adv > _width) && (x > 0)) { // Word doesn't fit on a line
+                if(line == GFX_LAYOUT_LINES - 1) {
+                    i = start;
+                    break;
+                }
+                _start[++line] = start;
+                x = 0;
+            }
+        }
+        x += adv;
+    }
+    _start[line + 1] = i;
+    return _lines = line + 1;
+}
+
+// Number of lines laid out, and the distance between them
+uint16_t GFXtextLayout::lines(void) const {
+    return _len ? _lines : 0;
+}
+
+uint16_t GFXtextLayout::lineHeight(void) const {
+    return (_font ? (uint8_t)pgm_read_byte(&_font->yAdvance) : 8) * _size;
+}
+
+// Draw 'count' lines starting with line 'first', the first at (x, y)
+// as given to setCursor(), in the text color and font set when laid out
+void GFXtextLayout::drawLines(int16_t x, int16_t y, uint16_t first,
+  uint16_t count) {
+    if(!_len || (first >= _lines)) return;
+    if(count > _lines - first) count = _lines - first;
+
+    boolean wrap = _gfx->wrap;
+    int16_t h    = lineHeight();
+    _gfx->wrap   = false;
+    for(uint16_t l=first; l<first+count; l++, y+=h) {
+        uint16_t i = _start[l], end = _start[l + 1];
+        uint8_t  c;
+        while(end > i) { // Leave out the line break and trailing spaces
+            c = _pgm ? pgm_read_byte(&_str[end - 1]) : _str[end - 1];
+            if((c != '\n') && (c != '\r') && (c != ' ')) break;
+            end--;
+        }
+        _gfx->setCursor(x, y);
+        _gfx->utf8Left = 0;
+        for(; i<end; i++) {
+            _gfx->write(_pgm ? pgm_read_byte(&_str[i]) : _str[i]);
+        }
+    }
+    _gfx->wrap = wrap;
+}
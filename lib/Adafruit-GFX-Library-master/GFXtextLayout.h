@@ -0,0 +1,45 @@
+#ifndef _GFXTEXTLAYOUT_H_
+#define _GFXTEXTLAYOUT_H_
+
+#include "Adafruit_GFX.h"
+
+#define GFX_LAYOUT_LINES 16 // Most lines a GFXtextLayout holds
+
+// Word-wrapped text.  layout() finds the line breaks for a string in
+// the display's current font and size, once: called again with the
+// same string (compared with a copy it keeps), font, size and width it
+// returns the stored result.
+// drawLines() then draws any range of lines without measuring again,
+// e.g. one screenful of a long message per frame.
+class GFXtextLayout {
+
+ public:
+  GFXtextLayout(void);
+  ~GFXtextLayout(void);
+  uint16_t
+    layout(Adafruit_GFX *gfx, const char *str, int16_t width),
+    layout(Adafruit_GFX *gfx, const __FlashStringHelper *str, int16_t width),
+    lines(void) const,
+    lineHeight(void) const;
+  void
+    drawLines(int16_t x, int16_t y, uint16_t first, uint16_t count);
+
+ private:
+  uint16_t breakLines(Adafruit_GFX *gfx, const char *str, boolean pgm,
+    int16_t width);
+  Adafruit_GFX *_gfx;
+  const char   *_str;
+  char         *_text;  // Copy of the string laid out, if _copied
+  GFXfont      *_font;
+  uint16_t      _room,  // Bytes allocated for _text
+                _len,   // String length + 1; 0 if nothing laid out
+                _lines,
+                _start[GFX_LAYOUT_LINES + 1]; // Offset of each line,
+                                              // then of the end
+  int16_t       _width;
+  uint8_t       _size;
+  boolean       _pgm,
+                _copied;
+};
+
+#endif // _GFXTEXTLAYOUT_H_
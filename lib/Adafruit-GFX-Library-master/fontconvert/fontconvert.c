@@ -8,238 +8,995 @@ fonts to be used with the Adafruit_GFX Arduino library.
 For UNIX-like systems.  Outputs to stdout; redirect to header file, e.g.:
   ./fontconvert ~/Library/Fonts/FreeSans.ttf 18 > FreeSans18pt7b.h
 
+Several sizes can be converted at once into one header, e.g.:
+  ./fontconvert ~/Library/Fonts/FreeSans.ttf 9,18 > FreeSans7b.h
+This emits a GFXfont per size (FreeSans9pt7b, FreeSans18pt7b) sharing
+one bitmap table in which identical glyph images are stored only once,
+plus a GFXfontFamily (FreeSans7b) for setFontFamily(), which lets
+setTextSize() pick a native-resolution size instead of scaling pixels.
+
+Many fonts can be generated in one run from a manifest, e.g.:
+  ./fontconvert -m fonts.txt -j 8
+Each manifest line holds the arguments of one conversion (font file,
+size(s), optional first/last char, -c list, -s file, -r, -p or -b),
+plus 'in <dir>' and 'out <dir>' lines setting where following font
+files are read from and headers written to; '#' starts a comment.  Each
+header is named after the font it holds (e.g. FreeSans18pt7b.h, or .fnt
+with -b).  Fonts are rasterized on a pool of threads (default one per
+CPU, or -j), each with its own FreeType instance, and a header whose
+content hash matches the existing file isn't rewritten, so its
+timestamp is left alone.  Font files that don't exist are skipped.  See
+makefonts.sh.
+
+Characters beyond 7-bit ASCII can be picked with -c and a comma-separated
+list of codepoints and codepoint ranges, e.g.:
+  ./fontconvert -c 0x20-0x7E,0xC0-0xFF,0x20AC Lato-Regular.ttf 12
+The glyph table then holds only those characters, and the font gets a
+GFXrange table mapping runs of consecutive codepoints to it; text drawn
+with such a font is UTF-8.  Fonts with any codepoint above 0xFF are
+named ...16b.
+
+Or let the text the firmware draws pick the characters:
+  ./fontconvert -s ../../../src/main.cpp -c 0x30-0x39 FreeSans.ttf 9
+-s collects every character in a UTF-8 text file (e.g. a list of
+attendee names), or in the string literals of a C/C++ source, and
+converts just those, as with -c.
+
+For SSD1306-style monochrome displays, -p stores glyphs page-major
+(8-pixel vertical column bytes, see GFX_FONT_PAGED in gfxfont.h), which
+Adafruit_GFX can copy straight into a page-major display buffer.
+
+-b writes a binary font file instead of a header, for loading at run
+time with GFXfontFile (e.g. from SPIFFS); see GFXfontFile.h.  One size
+only; redirect to a file, e.g. FreeSans12pt7b.fnt.
+
 REQUIRES FREETYPE LIBRARY.  www.freetype.org
 
-Currently this only extracts the printable 7-bit ASCII chars of a font.
-Will eventually extend with some int'l chars a la ftGFX, not there yet.
+By default this extracts the printable 7-bit ASCII chars of a font.
 Keep 7-bit fonts around as an option in that case, more compact.
 
 See notes at end for glyph nomenclature & other tidbits.
 */
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
 #include <ctype.h>
 #include <stdint.h>
+#include <unistd.h>
+#include <pthread.h>
 #include <ft2build.h>
 #include FT_GLYPH_H
 #include "../gfxfont.h" // Adafruit_GFX font structures
 
-#define DPI 141 // Approximate res. of Adafruit 2.8" TFT
-
-// Accumulate bits for output, with periodic hexadecimal byte write
-void enbit(uint8_t value) {
-	static uint8_t row = 0, sum = 0, bit = 0x80, firstCall = 1;
-	if(value) sum |= bit;    // Set bit if needed
-	if(!(bit >>= 1)) {       // Advance to next bit, end of byte reached?
-		if(!firstCall) { // Format output table nicely
-			if(++row >= 12) {        // Last entry on line?
-				printf(",\n  "); //   Newline format output
-				row = 0;         //   Reset row counter
-			} else {                 // Not end of line
-				printf(", ");    //   Simple comma delim
+#define DPI       141 // Approximate res. of Adafruit 2.8" TFT
+#define MAX_SIZES   8 // Most sizes in one conversion
+#define OUT_BINARY 0x80 // convert() flag: write a GFXfontFile, not a header
+
+// Glyph bitmaps of all sizes are collected here, then printed as one
+// table once duplicates have been weeded out.  One per conversion, so
+// conversions can run in parallel.
+typedef struct {
+	uint8_t *data;
+	int      len, max;
+	uint8_t  sum, bit;    // enbit() state
+	uint8_t  nsum, nhi;   // ennibble() state
+} Bitmaps;
+
+// Header text, either written straight to a file or kept in memory
+typedef struct {
+	FILE   *fp;
+	char   *text;
+	size_t  len, max;
+} Output;
+
+// Append one byte to the bitmap table
+void enbyte(Bitmaps *b, uint8_t sum) {
+	if(b->len >= b->max) {
+		b->max = b->max ? b->max * 2 : 4096;
+		if(!(b->data = realloc(b->data, b->max))) {
+			fprintf(stderr, "Malloc error\n");
+			exit(1);
+		}
+	}
+	b->data[b->len++] = sum;
+}
+
+// Accumulate bits for output, appending each byte once complete
+void enbit(Bitmaps *b, uint8_t value) {
+	if(value) b->sum |= b->bit; // Set bit if needed
+	if(!(b->bit >>= 1)) {       // Advance to next bit, end of byte reached?
+		enbyte(b, b->sum);
+		b->sum = 0;         // Clear for next byte
+		b->bit = 0x80;      // Reset bit counter
+	}
+}
+
+// Accumulate 4-bit nibbles for output, high nibble first.  Pass -1 to
+// pad out a pending high nibble with 0 (does nothing if none pending).
+void ennibble(Bitmaps *b, int value) {
+	if(value < 0) {
+		if(b->nhi) return;
+		value = 0;
+	}
+	if(b->nhi) {
+		b->nsum = value << 4;
+		b->nhi  = 0;
+		return;
+	}
+	enbyte(b, b->nsum | value);
+	b->nhi = 1;
+}
+
+// Write one GFX_FONT_RLE run length as nibbles
+void enrun(Bitmaps *b, int run) {
+	for(; run >= 15; run -= 15) ennibble(b, 15);
+	ennibble(b, run);
+}
+
+// Append raw bytes (binary fonts)
+void outb(Output *o, const void *data, size_t n) {
+	if(o->fp) {
+		fwrite(data, 1, n, o->fp);
+		return;
+	}
+	if(o->len + n > o->max) {
+		o->max = (o->len + n) * 2;
+		if(!(o->text = realloc(o->text, o->max))) {
+			fprintf(stderr, "Malloc error\n");
+			exit(1);
+		}
+	}
+	memcpy(o->text + o->len, data, n);
+	o->len += n;
+}
+
+// printf() to a header
+void outf(Output *o, const char *fmt, ...) {
+	va_list ap;
+	int     n;
+	if(o->fp) {
+		va_start(ap, fmt);
+		vfprintf(o->fp, fmt, ap);
+		va_end(ap);
+		return;
+	}
+	for(;;) {
+		va_start(ap, fmt);
+		n = vsnprintf(o->text + o->len, o->max - o->len, fmt, ap);
+		va_end(ap);
+		if(o->len + n < o->max) break;
+		o->max = (o->max + n) * 2;
+		if(!(o->text = realloc(o->text, o->max))) {
+			fprintf(stderr, "Malloc error\n");
+			exit(1);
+		}
+	}
+	o->len += n;
+}
+
+// Sort comparator for size list
+int cmpint(const void *a, const void *b) {
+	return *(const int *)a - *(const int *)b;
+}
+
+// Parse a codepoint list ("0x20-0x7E,0xA9,...") into a sorted array
+// without duplicates.  Returns the number of codepoints, 0 on error.
+int parseChars(const char *chars, int **code) {
+	int         n = 0, max = 0, a, b, i, j;
+	char       *ptr;
+	const char *cptr = chars;
+
+	*code = NULL;
+	while(*cptr) {
+		a = b = strtol(cptr, &ptr, 0);
+		if(*ptr == '-') b = strtol(ptr + 1, &ptr, 0);
+		if((ptr == cptr) || (*ptr && (*ptr != ',')) ||
+		   (a < 1) || (b > 0xFFFF) || (b < a)) {
+			fprintf(stderr, "Bad character list: %s\n", chars);
+			free(*code);
+			return 0;
+		}
+		for(i=a; i<=b; i++) {
+			if(n >= max) {
+				max = max ? max * 2 : 256;
+				if(!(*code = realloc(*code, max * sizeof(int)))) {
+					fprintf(stderr, "Malloc error\n");
+					exit(1);
+				}
 			}
+			(*code)[n++] = i;
 		}
-		printf("0x%02X", sum); // Write byte value
-		sum       = 0;         // Clear for next byte
-		bit       = 0x80;      // Reset bit counter
-		firstCall = 0;         // Formatting flag
+		cptr = *ptr ? ptr + 1 : ptr; // Skip comma
+	}
+	qsort(*code, n, sizeof(int), cmpint);
+	for(i=j=0; i<n; i++) {
+		if(!j || ((*code)[i] != (*code)[j - 1])) (*code)[j++] = (*code)[i];
 	}
+	return j;
 }
 
-int main(int argc, char *argv[]) {
-	int                i, j, err, size, first=' ', last='~',
-	                   bitmapOffset = 0, x, y, byte;
-	char              *fontName, c, *ptr;
-	FT_Library         library;
+// Write a font as a GFXfontFile (see GFXfontFile.h) rather than a header
+void outBinary(Output *out, GFXglyph *t, int *len, int count, int *code,
+  int ranges, Bitmaps *bits, int first, int last, int yAdvance, int flags) {
+	uint8_t hdr[20] = { 'G', 'F', 'X', 'F', 1 }, rec[9];
+	int     i, j, k, maxLen = 0, nRanges = 0;
+
+	for(i=0; i<count; i++) if(len[i] > maxLen) maxLen = len[i];
+	if(ranges) {
+		for(j=0; j<count; j=k, nRanges++) {
+			for(k=j+1; (k < count) && (code[k] == code[k - 1] + 1); k++);
+		}
+	}
+	hdr[5]  = flags;
+	hdr[6]  = (first > 0xFF) ? 0xFF : first;
+	hdr[7]  = (last  > 0xFF) ? 0xFF : last;
+	hdr[8]  = yAdvance;
+	hdr[10] = count;
+	hdr[11] = count >> 8;
+	hdr[12] = nRanges;
+	hdr[13] = nRanges >> 8;
+	hdr[14] = maxLen;
+	hdr[15] = maxLen >> 8;
+	for(i=0; i<4; i++) hdr[16 + i] = bits->len >> (i * 8);
+	outb(out, hdr, sizeof(hdr));
+	for(j=0; ranges && (j<count); j=k) {
+		for(k=j+1; (k < count) && (code[k] == code[k - 1] + 1); k++);
+		rec[0] = code[j];
+		rec[1] = code[j] >> 8;
+		rec[2] = code[k - 1];
+		rec[3] = code[k - 1] >> 8;
+		rec[4] = j;
+		rec[5] = j >> 8;
+		outb(out, rec, 6);
+	}
+	for(i=0; i<count; i++) {
+		rec[0] = t[i].bitmapOffset;
+		rec[1] = t[i].bitmapOffset >> 8;
+		rec[2] = len[i];
+		rec[3] = len[i] >> 8;
+		rec[4] = t[i].width;
+		rec[5] = t[i].height;
+		rec[6] = t[i].xAdvance;
+		rec[7] = t[i].xOffset;
+		rec[8] = t[i].yOffset;
+		outb(out, rec, 9);
+	}
+	outb(out, bits->data, bits->len);
+}
+
+// Build a -c list of the characters used in a text file, plus those in
+// 'chars' if non-NULL, so a font holds only what the firmware renders.
+// The file is UTF-8; in C/C++ sources only string and character literals
+// count (escapes other than \\ \" \' are dropped, \x digits taken as
+// is).  Control characters are left out.  Returns a malloc'd list, or
+// NULL on error.
+char *charsFromStrings(const char *filename, const char *chars) {
+	static const char *srcExt[] = { ".c", ".cpp", ".h", ".ino", NULL };
+	const char *ext = strrchr(filename, '.');
+	FILE       *fp;
+	uint8_t    *used;
+	char       *list = NULL;
+	int         c, i, j, n, *code, src = 0, quote = 0, esc = 0, comment = 0,
+	            prev = 0, cp = 0, left = 0, len = 0, max = 0;
+
+	if(!(fp = fopen(filename, "r"))) {
+		fprintf(stderr, "Can't open strings file %s\n", filename);
+		return NULL;
+	}
+	if(!(used = calloc(0x10000 / 8, 1))) {
+		fprintf(stderr, "Malloc error\n");
+		exit(1);
+	}
+	if(chars) {
+		if(!(n = parseChars(chars, &code))) {
+			fclose(fp);
+			free(used);
+			return NULL;
+		}
+		for(i=0; i<n; i++) used[code[i] >> 3] |= 1 << (code[i] & 7);
+		free(code);
+	}
+	for(i=0; ext && srcExt[i]; i++) {
+		if(!strcmp(ext, srcExt[i])) src = 1;
+	}
+
+	while((c = fgetc(fp)) != EOF) {
+		if(src) {
+			if(comment == 1) {         // Line comment
+				if(c == '\n') comment = 0;
+				continue;
+			} else if(comment == 2) {  // Block comment
+				if((prev == '*') && (c == '/')) comment = 0, c = 0;
+				prev = c;
+				continue;
+			} else if(!quote) {
+				if((prev == '/') && (c == '/'))      comment = 1;
+				else if((prev == '/') && (c == '*')) comment = 2, c = 0;
+				else if((c == '"') || (c == '\''))   quote   = c;
+				prev = c;
+				continue;
+			} else if(esc) {
+				esc = 0;
+				if(isalnum(c)) continue;   // \n, \t, \0...
+			} else if(c == '\\') {
+				esc = 1;
+				continue;
+			} else if(c == quote) {
+				quote = prev = 0;
+				continue;
+			}
+		}
+		// UTF-8 decode; anything beyond U+FFFF is skipped
+		if(c < 0x80) {
+			cp   = c;
+			left = 0;
+		} else if(c < 0xC0) {
+			if(!left) continue;
+			cp = (cp << 6) | (c & 0x3F);
+			if(--left) continue;
+		} else {
+			cp   = c & ((c < 0xE0) ? 0x1F : 0x0F);
+			left = (c < 0xE0) ? 1 : (c < 0xF0) ? 2 : 0;
+			continue;
+		}
+		if((cp >= ' ') && (cp != 0x7F)) used[cp >> 3] |= 1 << (cp & 7);
+	}
+	fclose(fp);
+
+	// Runs of consecutive codepoints become "first-last"
+	for(i=0; i<0x10000; i=j) {
+		if(!(used[i >> 3] & (1 << (i & 7)))) {
+			j = i + 1;
+			continue;
+		}
+		for(j=i+1; (j < 0x10000) && (used[j >> 3] & (1 << (j & 7))); j++);
+		if(len + 16 > max) {
+			max = max ? max * 2 : 256;
+			if(!(list = realloc(list, max))) {
+				fprintf(stderr, "Malloc error\n");
+				exit(1);
+			}
+		}
+		len += sprintf(&list[len], (j - i > 1) ? "%s0x%X-0x%X" : "%s0x%X",
+		  len ? "," : "", i, j - 1);
+	}
+	free(used);
+	if(!list) fprintf(stderr, "%s: no characters found\n", filename);
+	return list;
+}
+
+// Convert one font file in one or more sizes, writing a header to 'out'.
+// Characters are 'first' to 'last', or those listed in 'chars' if
+// non-NULL (see parseChars()).  'flags' picks the bitmap format:
+// GFX_FONT_RLE, GFX_FONT_PAGED or 0 for bit-packed.  If 'name' is
+// non-NULL it receives the (malloc'd) name of the header's main table:
+// the font if one size, the family if several.  OUT_BINARY in 'flags'
+// writes a single size as a GFXfontFile instead.
+int convert(FT_Library library, const char *filename, const char *sizes,
+  int first, int last, const char *chars, int flags, Output *out,
+  char **name) {
+	int                i, j, k, s, err, count, size[MAX_SIZES],
+	                   nSizes = 0, x, y, byte, *glyphLen, *code, nBits,
+	                   nRanges = 0;
+	long               yAdvance[MAX_SIZES];
+	char              *fontName[MAX_SIZES], *familyName, *bitmapName,
+	                  *ptr;
+	const char        *cptr;
 	FT_Face            face;
 	FT_Glyph           glyph;
 	FT_Bitmap         *bitmap;
 	FT_BitmapGlyphRec *g;
 	GFXglyph          *table;
 	uint8_t            bit;
+	Bitmaps            bits = { NULL, 0, 0, 0, 0x80, 0, 1 };
+	const char        *flagName = (flags & GFX_FONT_RLE) ? "GFX_FONT_RLE" :
+	                    (flags & GFX_FONT_PAGED) ? "GFX_FONT_PAGED" : "0";
 
-	// Parse command line.  Valid syntaxes are:
-	//   fontconvert [filename] [size]
-	//   fontconvert [filename] [size] [last char]
-	//   fontconvert [filename] [size] [first char] [last char]
-	// Unless overridden, default first and last chars are
-	// ' ' (space) and '~', respectively
-
-	if(argc < 3) {
-		fprintf(stderr, "Usage: %s fontfile size [first] [last]\n",
-		  argv[0]);
+	for(cptr = sizes; *cptr && (nSizes < MAX_SIZES); ) {
+		if((size[nSizes] = strtol(cptr, &ptr, 10)) > 0) nSizes++;
+		cptr = *ptr ? ptr + 1 : ptr; // Skip comma
+	}
+	if(!nSizes) {
+		fprintf(stderr, "%s: no valid size given\n", filename);
 		return 1;
 	}
-
-	size = atoi(argv[2]);
-
-	if(argc == 4) {
-		last  = atoi(argv[3]);
-	} else if(argc == 5) {
-		first = atoi(argv[3]);
-		last  = atoi(argv[4]);
+	qsort(size, nSizes, sizeof(int), cmpint); // Family is smallest first
+	if(flags & GFX_FONT_RLE) flags &= ~GFX_FONT_PAGED; // Not both
+	if((flags & OUT_BINARY) && (nSizes > 1)) {
+		fprintf(stderr, "%s: binary fonts take one size\n", filename);
+		return 1;
 	}
 
-	if(last < first) {
-		i     = first;
-		first = last;
-		last  = i;
+	if(chars) {
+		if(!(count = parseChars(chars, &code))) return 1;
+		first = code[0];
+		last  = code[count - 1];
+	} else {
+		if(last < first) {
+			i     = first;
+			first = last;
+			last  = i;
+		}
+		count = last - first + 1;
+		if(!(code = malloc(count * sizeof(int)))) {
+			fprintf(stderr, "Malloc error\n");
+			exit(1);
+		}
+		for(i=0; i<count; i++) code[i] = first + i;
 	}
+	nBits = (last > 0xFF) ? 16 : (last > 127) ? 8 : 7;
 
-	ptr = strrchr(argv[1], '/'); // Find last slash in filename
-	if(ptr) ptr++;         // First character of filename (path stripped)
-	else    ptr = argv[1]; // No path; font in local dir.
+	cptr = strrchr(filename, '/'); // Find last slash in filename
+	if(cptr) cptr++;          // First character of filename (path stripped)
+	else     cptr = filename; // No path; font in local dir.
 
-	// Allocate space for font name and glyph table
-	if((!(fontName = malloc(strlen(ptr) + 20))) ||
-	   (!(table = (GFXglyph *)malloc((last - first + 1) *
-	    sizeof(GFXglyph))))) {
+	// Allocate space for font names and glyph tables
+	if((!(familyName = malloc(strlen(cptr) + 20))) ||
+	   (!(table = (GFXglyph *)calloc(nSizes * count, sizeof(GFXglyph)))) ||
+	   (!(glyphLen = (int *)calloc(nSizes * count, sizeof(int))))) {
 		fprintf(stderr, "Malloc error\n");
-		return 1;
+		exit(1);
 	}
 
 	// Derive font table names from filename.  Period (filename
 	// extension) is truncated and replaced with the font size & bits.
-	strcpy(fontName, ptr);
-	ptr = strrchr(fontName, '.'); // Find last period (file ext)
-	if(!ptr) ptr = &fontName[strlen(fontName)]; // If none, append
-	// Insert font size and 7/8 bit.  fontName was alloc'd w/extra
-	// space to allow this, we're not sprintfing into Forbidden Zone.
-	sprintf(ptr, "%dpt%db", size, (last > 127) ? 8 : 7);
-	// Space and punctuation chars in name replaced w/ underscores.  
-	for(i=0; (c=fontName[i]); i++) {
-		if(isspace(c) || ispunct(c)) fontName[i] = '_';
-	}
-
-	// Init FreeType lib, load font
-	if((err = FT_Init_FreeType(&library))) {
-		fprintf(stderr, "FreeType init error: %d", err);
-		return err;
+	// Space and punctuation chars in name replaced w/ underscores.
+	strcpy(familyName, cptr);
+	ptr = strrchr(familyName, '.'); // Find last period (file ext)
+	if(ptr) *ptr = 0;
+	for(i=0; familyName[i]; i++) {
+		if(isspace(familyName[i]) || ispunct(familyName[i])) {
+			familyName[i] = '_';
+		}
 	}
-	if((err = FT_New_Face(library, argv[1], 0, &face))) {
-		fprintf(stderr, "Font load error: %d", err);
-		FT_Done_FreeType(library);
+	for(s=0; s<nSizes; s++) {
+		// Alloc'd w/extra space for size & bits, we're not sprintfing
+		// into Forbidden Zone.
+		if(!(fontName[s] = malloc(strlen(familyName) + 20))) {
+			fprintf(stderr, "Malloc error\n");
+			exit(1);
+		}
+		sprintf(fontName[s], "%s%dpt%db", familyName, size[s], nBits);
+	}
+	sprintf(&familyName[strlen(familyName)], "%db", nBits);
+	// One size keeps the old single-font naming throughout
+	bitmapName = (nSizes > 1) ? familyName : fontName[0];
+
+	// Load font
+	if((err = FT_New_Face(library, filename, 0, &face))) {
+		fprintf(stderr, "%s: font load error: %d\n", filename, err);
 		return err;
 	}
 
-	// << 6 because '26dot6' fixed-point format
-	FT_Set_Char_Size(face, size << 6, 0, DPI, 0);
+	for(s=0; s<nSizes; s++) {
+		GFXglyph *t   = &table[s * count];
+		int      *len = &glyphLen[s * count];
 
-	// Currently all symbols from 'first' to 'last' are processed.
-	// Fonts may contain WAY more glyphs than that, but this code
-	// will need to handle encoding stuff to deal with extracting
-	// the right symbols, and that's not done yet.
-	// fprintf(stderr, "%ld glyphs\n", face->num_glyphs);
+		// << 6 because '26dot6' fixed-point format
+		FT_Set_Char_Size(face, size[s] << 6, 0, DPI, 0);
+		yAdvance[s] = face->size->metrics.height >> 6;
 
-	printf("const uint8_t %sBitmaps[] PROGMEM = {\n  ", fontName);
+		// Process glyphs and build huge bitmap data array.  Characters
+		// are Unicode codepoints (FreeType picks a Unicode charmap
+		// by default).
+		for(j=0; j<count; j++) {
+			int start = bits.len;
+			i = code[j];
+			t[j].bitmapOffset = start;
 
-	// Process glyphs and output huge bitmap data array
-	for(i=first, j=0; i<=last; i++, j++) {
-		// MONO renderer provides clean image with perfect crop
-		// (no wasted pixels) via bitmap struct.
-		if((err = FT_Load_Char(face, i, FT_LOAD_TARGET_MONO))) {
-			fprintf(stderr, "Error %d loading char '%c'\n",
-			  err, i);
-			continue;
+			// MONO renderer provides clean image with perfect crop
+			// (no wasted pixels) via bitmap struct.
+			if((err = FT_Load_Char(face, i, FT_LOAD_TARGET_MONO))) {
+				fprintf(stderr, "Error %d loading char 0x%02X\n",
+				  err, i);
+				continue;
+			}
+
+			if((err = FT_Render_Glyph(face->glyph,
+			  FT_RENDER_MODE_MONO))) {
+				fprintf(stderr, "Error %d rendering char 0x%02X\n",
+				  err, i);
+				continue;
+			}
+
+			if((err = FT_Get_Glyph(face->glyph, &glyph))) {
+				fprintf(stderr, "Error %d getting glyph 0x%02X\n",
+				  err, i);
+				continue;
+			}
+
+			bitmap = &face->glyph->bitmap;
+			g      = (FT_BitmapGlyphRec *)glyph;
+
+			// Minimal font and per-glyph information is stored to
+			// reduce flash space requirements.  Glyph bitmaps are
+			// fully bit-packed; no per-scanline pad, though end of
+			// each character may be padded to next byte boundary
+			// when needed.  16-bit offset means 64K max for bitmaps
+			// (all sizes of a family share one table); a glyph that
+			// would start past that is an error, below.  (Doesn't
+			// check that size & offsets are within bounds either for
+			// that matter...please convert fonts responsibly.)
+			t[j].width        = bitmap->width;
+			t[j].height       = bitmap->rows;
+			t[j].xAdvance     = face->glyph->advance.x >> 6;
+			t[j].xOffset      = g->left;
+			t[j].yOffset      = 1 - g->top;
+
+			if(flags & GFX_FONT_RLE) {
+				// Alternating clear/set runs, starting with clear
+				int     run = 0;
+				uint8_t on  = 0;
+				for(y=0; y < bitmap->rows; y++) {
+					for(x=0;x < bitmap->width; x++) {
+						byte = x / 8;
+						bit  = 0x80 >> (x & 7);
+						if(!(bitmap->buffer[y * bitmap->pitch +
+						  byte] & bit) == !on) {
+							run++;
+						} else {
+							enrun(&bits, run);
+							run = 1;
+							on  = !on;
+						}
+					}
+				}
+				if(bitmap->width && bitmap->rows) enrun(&bits, run);
+				ennibble(&bits, -1); // Pad glyph to byte boundary
+			} else if(flags & GFX_FONT_PAGED) {
+				// Column bytes, page by page, starting from the row
+				// at yOffset rounded down to a multiple of 8
+				int top   = t[j].yOffset & 7,
+				    pages = (top + bitmap->rows + 7) / 8, p, b;
+				for(p=0; p<pages; p++) {
+					for(x=0; x < bitmap->width; x++) {
+						uint8_t col = 0;
+						bit = 0x80 >> (x & 7);
+						for(b=0; b<8; b++) {
+							y = p * 8 + b - top;
+							if((y >= 0) && (y < bitmap->rows) &&
+							   (bitmap->buffer[y * bitmap->pitch +
+							   x / 8] & bit)) col |= 1 << b;
+						}
+						enbyte(&bits, col);
+					}
+				}
+			} else {
+				for(y=0; y < bitmap->rows; y++) {
+					for(x=0;x < bitmap->width; x++) {
+						byte = x / 8;
+						bit  = 0x80 >> (x & 7);
+						enbit(&bits, bitmap->buffer[
+						  y * bitmap->pitch + byte] & bit);
+					}
+				}
+
+				// Pad end of char bitmap to next byte boundary if needed
+				int n = (bitmap->width * bitmap->rows) & 7;
+				if(n) { // Pixel count not an even multiple of 8?
+					n = 8 - n; // # bits to next multiple
+					while(n--) enbit(&bits, 0);
+				}
+			}
+
+			// If an identical image was already stored (same glyph
+			// in another size, or a look-alike such as 'l' and '|'),
+			// point there and drop the copy just added.
+			len[j] = bits.len - start;
+			for(k=0; len[j] && (k < s * count + j); k++) {
+				if((glyphLen[k] == len[j]) &&
+				   (table[k].width  == t[j].width) &&
+				   (table[k].height == t[j].height) &&
+				   (!(flags & GFX_FONT_PAGED) ||
+				     !((table[k].yOffset ^ t[j].yOffset) & 7)) &&
+				   !memcmp(&bits.data[table[k].bitmapOffset],
+				     &bits.data[start], len[j])) {
+					t[j].bitmapOffset = table[k].bitmapOffset;
+					bits.len          = start;
+					break;
+				}
+			}
+			// New bitmap data beyond what a 16-bit offset reaches?
+			if((bits.len > start) && (start > 0xFFFF)) {
+				fprintf(stderr, "%s: bitmaps pass 64K at %dpt char "
+				  "0x%02X, convert fewer sizes or characters\n",
+				  filename, size[s], i);
+				FT_Done_Glyph(glyph);
+				err = 1;
+				goto done;
+			}
+
+			FT_Done_Glyph(glyph);
 		}
+	}
 
-		if((err = FT_Render_Glyph(face->glyph,
-		  FT_RENDER_MODE_MONO))) {
-			fprintf(stderr, "Error %d rendering char '%c'\n",
-			  err, i);
-			continue;
+	if(flags & OUT_BINARY) {
+		outBinary(out, table, glyphLen, count, code, chars != NULL,
+		  &bits, first, last, yAdvance[0] ? yAdvance[0] : table[0].height,
+		  flags & ~OUT_BINARY);
+	} else {
+		// Output range table: runs of consecutive codepoints.  Shared by
+		// all sizes, as they have the same characters.
+		if(chars) {
+			outf(out, "const GFXrange %sRanges[] PROGMEM = {\n", bitmapName);
+			for(j=0; j<count; j=k) {
+				for(k=j+1; (k < count) && (code[k] == code[k - 1] + 1); k++);
+				if(nRanges++) outf(out, ",\n");
+				outf(out, "  { 0x%04X, 0x%04X, %5d }", code[j], code[k - 1], j);
+			}
+			outf(out, " };\n\n");
 		}
 
-		if((err = FT_Get_Glyph(face->glyph, &glyph))) {
-			fprintf(stderr, "Error %d getting glyph '%c'\n",
-			  err, i);
-			continue;
+		// Output huge bitmap data array
+		outf(out, "const uint8_t %sBitmaps[] PROGMEM = {\n  ", bitmapName);
+		for(i=0; i<bits.len; i++) {
+			if(i) outf(out, (i % 12) ? ", " : ",\n  "); // Format nicely
+			outf(out, "0x%02X", bits.data[i]);
 		}
+		outf(out, " };\n\n"); // End bitmap array
 
-		bitmap = &face->glyph->bitmap;
-		g      = (FT_BitmapGlyphRec *)glyph;
-
-		// Minimal font and per-glyph information is stored to
-		// reduce flash space requirements.  Glyph bitmaps are
-		// fully bit-packed; no per-scanline pad, though end of
-		// each character may be padded to next byte boundary
-		// when needed.  16-bit offset means 64K max for bitmaps,
-		// code currently doesn't check for overflow.  (Doesn't
-		// check that size & offsets are within bounds either for
-		// that matter...please convert fonts responsibly.)
-		table[j].bitmapOffset = bitmapOffset;
-		table[j].width        = bitmap->width;
-		table[j].height       = bitmap->rows;
-		table[j].xAdvance     = face->glyph->advance.x >> 6;
-		table[j].xOffset      = g->left;
-		table[j].yOffset      = 1 - g->top;
-
-		for(y=0; y < bitmap->rows; y++) {
-			for(x=0;x < bitmap->width; x++) {
-				byte = x / 8;
-				bit  = 0x80 >> (x & 7);
-				enbit(bitmap->buffer[
-				  y * bitmap->pitch + byte] & bit);
+		for(s=0; s<nSizes; s++) {
+			GFXglyph *t = &table[s * count];
+
+			// Output glyph attributes table (one per character)
+			outf(out, "const GFXglyph %sGlyphs[] PROGMEM = {\n", fontName[s]);
+			for(j=0; j<count; j++) {
+				i = code[j];
+				outf(out, "  { %5d, %3d, %3d, %3d, %4d, %4d }",
+				  t[j].bitmapOffset,
+				  t[j].width,
+				  t[j].height,
+				  t[j].xAdvance,
+				  t[j].xOffset,
+				  t[j].yOffset);
+				if(j < count - 1) {
+					outf(out, ",   // 0x%02X", i);
+					if((i >= ' ') && (i <= '~')) {
+						outf(out, " '%c'", i);
+					}
+					outf(out, "\n");
+				}
+			}
+			outf(out, " }; // 0x%02X", last);
+			if((last >= ' ') && (last <= '~')) outf(out, " '%c'", last);
+			outf(out, "\n\n");
+
+			// Output font structure.  first/last are only 8 bits; with a
+			// range table they're informational.
+			if(first > 0xFF) first = 0xFF;
+			if(last  > 0xFF) last  = 0xFF;
+			outf(out, "const GFXfont %s PROGMEM = {\n", fontName[s]);
+			outf(out, "  (uint8_t  *)%sBitmaps,\n", bitmapName);
+			outf(out, "  (GFXglyph *)%sGlyphs,\n", fontName[s]);
+			if (yAdvance[s] == 0) {
+		      // No face height info, assume fixed width and get from a glyph.
+				outf(out, "  0x%02X, 0x%02X, %d", first, last, t[0].height);
+			} else {
+				outf(out, "  0x%02X, 0x%02X, %ld", first, last, yAdvance[s]);
+			}
+			if(chars) {
+				outf(out, ", %s,\n  (GFXrange *)%sRanges, %d };\n\n",
+				  flagName, bitmapName, nRanges);
+			} else if(flags) {
+				outf(out, ", %s };\n\n", flagName);
+			} else {
+				outf(out, " };\n\n");
 			}
 		}
 
-		// Pad end of char bitmap to next byte boundary if needed
-		int n = (bitmap->width * bitmap->rows) & 7;
-		if(n) { // Pixel count not an even multiple of 8?
-			n = 8 - n; // # bits to next multiple
-			while(n--) enbit(0);
+		// Output family tying the sizes together
+		if(nSizes > 1) {
+			outf(out, "const GFXfont *const %sSizes[] PROGMEM = {\n", familyName);
+			for(s=0; s<nSizes; s++) {
+				outf(out, "  &%s%s\n", fontName[s],
+				  (s < nSizes - 1) ? "," : " };");
+			}
+			outf(out, "\nconst GFXfontFamily %s PROGMEM = {\n", familyName);
+			outf(out, "  (GFXfont **)%sSizes, %d };\n\n", familyName, nSizes);
 		}
-		bitmapOffset += (bitmap->width * bitmap->rows + 7) / 8;
 
-		FT_Done_Glyph(glyph);
+		outf(out, "// Approx. %d bytes\n", bits.len + nSizes * (count * 7 + 7) +
+		  ((nSizes > 1) ? nSizes * 2 + 3 : 0) +
+		  (chars ? nRanges * 6 + nSizes * 4 : 0));
+		// Size estimate is based on AVR struct and pointer sizes;
+		// actual size may vary.
 	}
 
-	printf(" };\n\n"); // End bitmap array
+	err = 0;
+done:
+	FT_Done_Face(face);
+	if(!err && name) *name = strdup(bitmapName);
+	for(s=0; s<nSizes; s++) free(fontName[s]);
+	free(familyName);
+	free(table);
+	free(glyphLen);
+	free(code);
+	free(bits.data);
 
-	// Output glyph attributes table (one per character)
-	printf("const GFXglyph %sGlyphs[] PROGMEM = {\n", fontName);
-	for(i=first, j=0; i<=last; i++, j++) {
-		printf("  { %5d, %3d, %3d, %3d, %4d, %4d }",
-		  table[j].bitmapOffset,
-		  table[j].width,
-		  table[j].height,
-		  table[j].xAdvance,
-		  table[j].xOffset,
-		  table[j].yOffset);
-		if(i < last) {
-			printf(",   // 0x%02X", i);
-			if((i >= ' ') && (i <= '~')) {
-				printf(" '%c'", i);
+	return err;
+}
+
+// BATCH MODE --------------------------------------------------------------
+
+typedef struct { // One manifest line
+	char *file, *sizes, *outDir, *chars;
+	int   first, last, flags;
+} Job;
+
+static Job            *jobs;
+static int             nJobs, nextJob, nWritten, nSame, nFailed;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+
+// 64-bit FNV-1a hash
+uint64_t fnv1a(const char *p, size_t len) {
+	uint64_t h = 0xCBF29CE484222325ULL;
+	while(len--) h = (h ^ (uint8_t)*p++) * 0x100000001B3ULL;
+	return h;
+}
+
+// Worker thread: own FreeType instance, takes jobs until none are left
+void *worker(void *arg) {
+	FT_Library library;
+	int        err, n;
+	(void)arg;
+
+	if((err = FT_Init_FreeType(&library))) {
+		fprintf(stderr, "FreeType init error: %d\n", err);
+		return NULL;
+	}
+
+	for(;;) {
+		pthread_mutex_lock(&lock);
+		n = nextJob++;
+		pthread_mutex_unlock(&lock);
+		if(n >= nJobs) break;
+
+		Job    *job  = &jobs[n];
+		Output  out  = { NULL, NULL, 0, 0 };
+		char   *name = NULL, *path = NULL, *old = NULL;
+		long    oldLen = -1;
+		FILE   *fp;
+		int     result;
+
+		if(access(job->file, R_OK)) { // Missing combination, skip
+			continue;
+		}
+		if(convert(library, job->file, job->sizes, job->first, job->last,
+		  job->chars, job->flags, &out, &name) || !(path = malloc(strlen(job->outDir) +
+		  strlen(name) + 5))) {
+			result = 2;
+		} else {
+			sprintf(path, "%s%s.%s", job->outDir, name,
+			  (job->flags & OUT_BINARY) ? "fnt" : "h");
+			// Read existing header to compare content hash
+			if((fp = fopen(path, "rb"))) {
+				fseek(fp, 0, SEEK_END);
+				oldLen = ftell(fp);
+				rewind(fp);
+				if((old = malloc(oldLen + 1)) &&
+				   (fread(old, 1, oldLen, fp) != (size_t)oldLen)) {
+					oldLen = -1;
+				}
+				fclose(fp);
+			}
+			if((oldLen == (long)out.len) && old &&
+			   (fnv1a(old, oldLen) == fnv1a(out.text, out.len))) {
+				result = 1;
+			} else if((fp = fopen(path, "wb")) &&
+			   (fwrite(out.text, 1, out.len, fp) == out.len)) {
+				fclose(fp);
+				result = 0;
+			} else {
+				if(fp) fclose(fp);
+				fprintf(stderr, "%s: write error\n", path);
+				result = 2;
 			}
-			putchar('\n');
 		}
-	}
-	printf(" }; // 0x%02X", last);
-	if((last >= ' ') && (last <= '~')) printf(" '%c'", last);
-	printf("\n\n");
 
-	// Output font structure
-	printf("const GFXfont %s PROGMEM = {\n", fontName);
-	printf("  (uint8_t  *)%sBitmaps,\n", fontName);
-	printf("  (GFXglyph *)%sGlyphs,\n", fontName);
-	if (face->size->metrics.height == 0) {
-      // No face height info, assume fixed width and get from a glyph.
-		printf("  0x%02X, 0x%02X, %d };\n\n",
-			first, last, table[0].height);
-	} else {
-		printf("  0x%02X, 0x%02X, %ld };\n\n",
-			first, last, face->size->metrics.height >> 6);
+		pthread_mutex_lock(&lock);
+		if(result == 0)      nWritten++;
+		else if(result == 1) nSame++;
+		else                 nFailed++;
+		pthread_mutex_unlock(&lock);
+
+		free(old);
+		free(path);
+		free(name);
+		free(out.text);
 	}
-	printf("// Approx. %d bytes\n",
-	  bitmapOffset + (last - first + 1) * 7 + 7);
-	// Size estimate is based on AVR struct and pointer sizes;
-	// actual size may vary.
 
 	FT_Done_FreeType(library);
+	return NULL;
+}
+
+// Read manifest (or stdin if "-") into the job list
+int readManifest(const char *filename) {
+	FILE *fp = strcmp(filename, "-") ? fopen(filename, "r") : stdin;
+	char  line[1024], *inDir = strdup(""), *outDir = strdup(""), *tok[10],
+	     *chars, *strings;
+	int   i, j, n, maxJobs = 0, lineNum = 0;
 
+	if(!fp) {
+		fprintf(stderr, "Can't open manifest %s\n", filename);
+		return 1;
+	}
+	while(fgets(line, sizeof(line), fp)) {
+		lineNum++;
+		if((tok[0] = strchr(line, '#'))) *tok[0] = 0; // Strip comment
+		for(n=0; (n < 10) && (tok[n] = strtok(n ? NULL : line, " \t\r\n"));) {
+			n++;
+		}
+		// Pull out '-c list' and '-s file' wherever they are on the line
+		for(chars=strings=NULL, i=0; i<n-1; ) {
+			if(!strcmp(tok[i], "-c") || !strcmp(tok[i], "-s")) {
+				if(tok[i][1] == 'c') chars   = tok[i + 1];
+				else                 strings = tok[i + 1];
+				for(j=i, n-=2; j<n; j++) tok[j] = tok[j + 2];
+			} else {
+				i++;
+			}
+		}
+		if(!n) continue;
+		if(!strcmp(tok[0], "in") || !strcmp(tok[0], "out")) {
+			char **dir = (tok[0][0] == 'i') ? &inDir : &outDir;
+			const char *d = (n > 1) ? tok[1] : "";
+			size_t      l = strlen(d);
+			free(*dir);
+			*dir = malloc(l + 2);
+			strcpy(*dir, d);
+			if(l && (d[l - 1] != '/')) strcat(*dir, "/");
+			continue;
+		}
+		if(n < 2) {
+			fprintf(stderr, "%s:%d: font file and size expected\n",
+			  filename, lineNum);
+			return 1;
+		}
+		if(nJobs >= maxJobs) {
+			maxJobs = maxJobs ? maxJobs * 2 : 64;
+			if(!(jobs = realloc(jobs, maxJobs * sizeof(Job)))) {
+				fprintf(stderr, "Malloc error\n");
+				exit(1);
+			}
+		}
+		Job *job   = &jobs[nJobs++];
+		for(job->flags=0; n > 2; n--) { // Trailing format options
+			if(!strcmp(tok[n - 1], "-r"))      job->flags |= GFX_FONT_RLE;
+			else if(!strcmp(tok[n - 1], "-p")) job->flags |= GFX_FONT_PAGED;
+			else if(!strcmp(tok[n - 1], "-b")) job->flags |= OUT_BINARY;
+			else break;
+		}
+		job->first = ' ';
+		job->last  = '~';
+		if(n == 3) {
+			job->last  = atoi(tok[2]);
+		} else if(n >= 4) {
+			job->first = atoi(tok[2]);
+			job->last  = atoi(tok[3]);
+		}
+		job->file   = malloc(strlen(inDir) + strlen(tok[0]) + 1);
+		sprintf(job->file, "%s%s", inDir, tok[0]);
+		job->sizes  = strdup(tok[1]);
+		job->outDir = strdup(outDir);
+		if(strings) {
+			if(!(job->chars = charsFromStrings(strings, chars))) return 1;
+		} else {
+			job->chars = chars ? strdup(chars) : NULL;
+		}
+	}
+	if(fp != stdin) fclose(fp);
+	free(inDir);
+	free(outDir);
 	return 0;
 }
 
+int main(int argc, char *argv[]) {
+	int        i, err, first=' ', last='~', flags = 0, threads = 0;
+	char      *manifest = NULL, *chars = NULL, *strings = NULL;
+	FT_Library library;
+	Output     out = { stdout, NULL, 0, 0 };
+
+	// Parse command line.  Valid syntaxes are:
+	//   fontconvert [-r|-p] [filename] [size]
+	//   fontconvert [-r|-p] [filename] [size] [last char]
+	//   fontconvert [-r|-p] [filename] [size] [first char] [last char]
+	//   fontconvert [-r|-p] -c [char list] [filename] [size]
+	//   fontconvert [-r|-p] -s [strings file] [filename] [size]
+	//   fontconvert -b [-r|-p] [filename] [size] > [font file]
+	//   fontconvert -m [manifest file] [-j threads]
+	// Unless overridden, default first and last chars are
+	// ' ' (space) and '~', respectively.  -r run-length encodes the
+	// glyph bitmaps (see GFX_FONT_RLE in gfxfont.h); it saves flash
+	// from about 18 point, breaks even near 12 and costs space below
+	// that, though text from 9 point up draws faster.  -p instead
+	// stores them page-major (GFX_FONT_PAGED) for SSD1306-type
+	// displays.  -b outputs a binary GFXfontFile.  [size] may be
+	// a comma-separated list of sizes, e.g. 9,12,18.  -c takes
+	// codepoints and ranges of them, e.g. 0x20-0x7E,0xC0-0xFF,0x20AC,
+	// and adds a GFXrange table to the font (see gfxfont.h).  -s does
+	// the same for the characters found in a file (plus any -c list).
+
+	while((argc > 1) && (argv[1][0] == '-') && argv[1][1]) {
+		if(!strcmp(argv[1], "-r")) {
+			flags |= GFX_FONT_RLE;
+		} else if(!strcmp(argv[1], "-p")) {
+			flags |= GFX_FONT_PAGED;
+		} else if(!strcmp(argv[1], "-b")) {
+			flags |= OUT_BINARY;
+		} else if(!strcmp(argv[1], "-m") && (argc > 2)) {
+			manifest = argv[2];
+			argv++;
+			argc--;
+		} else if(!strcmp(argv[1], "-c") && (argc > 2)) {
+			chars = argv[2];
+			argv++;
+			argc--;
+		} else if(!strcmp(argv[1], "-s") && (argc > 2)) {
+			strings = argv[2];
+			argv++;
+			argc--;
+		} else if(!strcmp(argv[1], "-j") && (argc > 2)) {
+			threads = atoi(argv[2]);
+			argv++;
+			argc--;
+		} else {
+			break;
+		}
+		argv++;
+		argc--;
+	}
+
+	if(manifest) {
+		pthread_t *tid;
+		if(readManifest(manifest)) return 1;
+		if(threads < 1) threads = sysconf(_SC_NPROCESSORS_ONLN);
+		if(threads < 1) threads = 1;
+		if(threads > nJobs) threads = nJobs;
+		if(!(tid = malloc(threads * sizeof(pthread_t)))) {
+			fprintf(stderr, "Malloc error\n");
+			return 1;
+		}
+		for(i=0; i<threads; i++) {
+			pthread_create(&tid[i], NULL, worker, NULL);
+		}
+		for(i=0; i<threads; i++) pthread_join(tid[i], NULL);
+		fprintf(stderr, "%d written, %d unchanged, %d failed\n",
+		  nWritten, nSame, nFailed);
+		return nFailed ? 1 : 0;
+	}
+
+	if(strings && !(chars = charsFromStrings(strings, chars))) return 1;
+
+	if(argc < 3) {
+		fprintf(stderr,
+		  "Usage: %s [-r|-p] [-b] [-c chars] [-s strings] fontfile size[,size...] [first] [last]\n"
+		  "       %s -m manifest [-j threads]\n", argv[0], argv[0]);
+		return 1;
+	}
+
+	if(argc == 4) {
+		last  = atoi(argv[3]);
+	} else if(argc == 5) {
+		first = atoi(argv[3]);
+		last  = atoi(argv[4]);
+	}
+
+	// Init FreeType lib
+	if((err = FT_Init_FreeType(&library))) {
+		fprintf(stderr, "FreeType init error: %d", err);
+		return err;
+	}
+
+	err = convert(library, argv[1], argv[2], first, last, chars, flags, &out,
+	  NULL);
+
+	FT_Done_FreeType(library);
+
+	return err;
+}
+
 /* -------------------------------------------------------------------------
 
 Character metrics are slightly different from classic GFX & ftGFX.
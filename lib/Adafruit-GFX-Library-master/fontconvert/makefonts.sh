@@ -5,8 +5,10 @@
 # 'Sans' (Helvetica-like) and 'Serif' (Times-like); four styles: regular,
 # bold, oblique or italic, and bold+oblique or bold+italic; and four
 # sizes: 9, 12, 18 and 24 point.  No real error checking or anything,
-# this just powers through all the combinations, calling the fontconvert
-# utility and redirecting the output to a .h file for each combo.
+# this just lists all the combinations in a manifest for the fontconvert
+# utility, which converts them in parallel and writes a .h file for
+# each combo (missing source combinations are skipped, and headers
+# that come out the same as before are left untouched).
 
 # Adafruit_GFX repository does not include the source outline fonts
 # (huge zipfile, different license) but they're easily acquired:
@@ -19,20 +21,17 @@ fonts=(FreeMono FreeSans FreeSerif)
 styles=("" Bold Italic BoldItalic Oblique BoldOblique)
 sizes=(9 12 18 24)
 
-for f in ${fonts[*]}
-do
-	for index in ${!styles[*]}
+{
+	echo "in $inpath"
+	echo "out $outpath"
+	for f in ${fonts[*]}
 	do
-		st=${styles[$index]}
-		for si in ${sizes[*]}
+		for st in "${styles[@]}"
 		do
-			infile=$inpath$f$st".ttf"
-			if [ -f $infile ] # Does source combination exist?
-			  then
-				outfile=$outpath$f$st$si"pt7b.h"
-#				printf "%s %s %s > %s\n" $convert $infile $si $outfile
-				$convert $infile $si > $outfile
-			fi
+			for si in ${sizes[*]}
+			do
+				echo "$f$st.ttf $si"
+			done
 		done
 	done
-done
+} | $convert -m -
@@ -14,11 +14,41 @@ typedef struct { // Data stored PER GLYPH
 	int8_t   xOffset, yOffset; // Dist from cursor pos to UL corner
 } GFXglyph;
 
+typedef struct { // Run of consecutive codepoints in a sparse font
+	uint16_t first, last;  // Unicode extents (inclusive)
+	uint16_t glyphIndex;   // Glyph array index of 'first'
+} GFXrange;
+
 typedef struct { // Data stored for FONT AS A WHOLE:
 	uint8_t  *bitmap;      // Glyph bitmaps, concatenated
 	GFXglyph *glyph;       // Glyph array
 	uint8_t   first, last; // ASCII extents
 	uint8_t   yAdvance;    // Newline distance (y axis)
+	uint8_t   flags;       // GFX_FONT_* bits; 0 (omitted) for plain fonts
+	GFXrange *range;       // If rangeCount: codepoint ranges, ascending,
+	uint16_t  rangeCount;  // used instead of first/last; text is UTF-8
 } GFXfont;
 
+// Glyph bitmaps are run-length encoded rather than bit-packed.  Each
+// glyph's pixels, read row by row, are stored as alternating runs of
+// clear and set pixels, starting with clear (possibly 0 long).  A run
+// is one or more 4-bit nibbles, high nibble first, summed until a
+// nibble other than 15 is read.  Each glyph starts on a byte boundary.
+// Produced by 'fontconvert -r'; large fonts shrink by around 40%.
+#define GFX_FONT_RLE 0x01
+
+// Glyph bitmaps are page-major, as on SSD1306-style displays: bytes are
+// 8-pixel vertical columns, LSB on top, one band of 'width' columns per
+// 8-row page.  Bit 0 of the first page is the row at yOffset rounded
+// down to a multiple of 8, so the glyph starts (yOffset & 7) bits into
+// its first page and text with the baseline on a page boundary can be
+// copied to a page-major buffer without shifting.  A glyph takes
+// ((yOffset & 7) + height + 7) / 8 pages.  Produced by 'fontconvert -p'.
+#define GFX_FONT_PAGED 0x02
+
+typedef struct { // One face in several sizes, see setFontFamily()
+	GFXfont **font;  // Fonts, smallest first
+	uint8_t   count; // Number of sizes
+} GFXfontFamily;
+
 #endif // _GFXFONT_H_
@@ -0,0 +1,661 @@
+// Checks of what the golden images can't show: canvas transforms against
+// the per-pixel drawing they replace, bytes on the SPI bus, mirror stream
+// round trips, GFXcounter's counts, QR symbols against known-good ones,
+// GFXtextLayout's line widths and reuse of a layout, and images and fonts
+// read from (mock) files.
+
+#include "gfx_test.h"
+#include "Adafruit_SPITFT.h"
+#include "Adafruit_SPITFT_Macros.h"
+#include "GFXanimation.h"
+#include "GFXcounter.h"
+#include "GFXfontFile.h"
+#include "GFXimageFile.h"
+#include "GFXmirror.h"
+#include "GFXqrcode.h"
+#include "GFXtextLayout.h"
+#include "Fonts/FreeSans9pt7b.h"
+
+static uint8_t get1(GFXcanvas1 *c, int16_t x, int16_t y) {
+    return (c->getBuffer()[y * ((c->width() + 7) / 8) + x / 8] >>
+      (7 - (x & 7))) & 1;
+}
+
+// SPITFT ----------------------------------------------------------------
+
+class TestTFT : public Adafruit_SPITFT {
+ public:
+  TestTFT(void) : Adafruit_SPITFT(320, 240, 5, 4) { }
+  void begin(uint32_t) { }
+  void setAddrWindow(uint16_t, uint16_t, uint16_t, uint16_t) { }
+};
+
+// One fill color as sent: n pixels, high byte first
+static int sentColor(uint16_t color, uint32_t n) {
+    if(SPI.sent.size() != n * 2) {
+        printf("  %u bytes sent for %u pixels\n",
+          (unsigned)SPI.sent.size(), n);
+        return 1;
+    }
+    for(uint32_t i=0; i<n * 2; i+=2) {
+        if((SPI.sent[i] != (color >> 8)) || (SPI.sent[i + 1] != (color & 0xFF))) {
+            printf("  wrong color at pixel %u\n", i / 2);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Fills go out as SPI_FILL_PIXELS-pixel patterns, whatever the length
+static int checkFill(void) {
+    TestTFT  tft;
+    int      bad = 0;
+    uint32_t n   = 320L * 240;
+
+    SPI.reset();
+    tft.fillScreen(0x1234);
+    bad += sentColor(0x1234, n);
+    printf("  fillScreen: %u transactions, %.1f pixels each\n",
+      SPI.transactions, (double)n / SPI.transactions);
+    if(SPI.transactions > n / SPI_FILL_PIXELS + 2) bad++;
+
+    const uint16_t lens[] = { 1, 17, SPI_FILL_PIXELS, SPI_FILL_PIXELS + 1, 999 };
+    for(uint8_t i=0; i<sizeof(lens) / sizeof(lens[0]); i++) {
+        SPI.reset();
+        tft.fillRect(3, 3, lens[i], 1, 0xBEEF - i);
+        bad += sentColor(0xBEEF - i, lens[i] < 317 ? lens[i] : 317);
+    }
+    return bad;
+}
+
+// Canvas transforms -----------------------------------------------------
+
+// rotateInto() matches drawing through setRotation(), and leaves a 1-bit
+// destination's row padding clear
+static int checkRotate(void) {
+    static const uint16_t sizes[][2] = {
+      { 128, 32 }, { 37, 13 }, { 8, 8 }, { 9, 17 }, { 64, 64 }, { 1, 5 },
+      { 5, 1 }, { 100, 3 }
+    };
+    int bad = 0;
+
+    srand(29);
+    for(uint8_t s=0; s<sizeof(sizes) / sizeof(sizes[0]); s++) {
+        uint16_t w = sizes[s][0], h = sizes[s][1];
+        GFXcanvas1  a(w, h);
+        GFXcanvas8  b(w, h);
+        GFXcanvas16 c(w, h);
+        std::vector<uint16_t> v(w * h);
+        for(uint16_t y=0; y<h; y++) {
+            for(uint16_t x=0; x<w; x++) {
+                uint16_t p = v[y * w + x] = rand();
+                a.drawPixel(x, y, p & 1);
+                b.drawPixel(x, y, p & 0xFF);
+                c.drawPixel(x, y, p);
+            }
+        }
+        for(uint8_t r=0; r<4; r++) {
+            uint16_t    dw = (r & 1) ? h : w, dh = (r & 1) ? w : h;
+            GFXcanvas1  a2(dw, dh), a3(dw, dh);
+            GFXcanvas8  b2(dw, dh), b3(dw, dh);
+            GFXcanvas16 c2(dw, dh), c3(dw, dh);
+            a2.fillScreen(1); // Padding must come out clear regardless
+            a3.setRotation(r);
+            b3.setRotation(r);
+            c3.setRotation(r);
+            for(uint16_t y=0; y<h; y++) {
+                for(uint16_t x=0; x<w; x++) {
+                    uint16_t p = v[y * w + x];
+                    a3.drawPixel(x, y, p & 1);
+                    b3.drawPixel(x, y, p & 0xFF);
+                    c3.drawPixel(x, y, p);
+                }
+            }
+            if(!a.rotateInto(&a2, r) || !b.rotateInto(&b2, r) ||
+              !c.rotateInto(&c2, r)) {
+                printf("  %ux%u rotation %u refused\n", w, h, r);
+                bad++;
+                continue;
+            }
+            if(memcmp(a2.getBuffer(), a3.getBuffer(), (dw + 7) / 8 * dh) ||
+              memcmp(b2.getBuffer(), b3.getBuffer(), dw * dh) ||
+              memcmp(c2.getBuffer(), c3.getBuffer(), dw * dh * 2)) {
+                printf("  %ux%u rotation %u differs\n", w, h, r);
+                bad++;
+            }
+        }
+    }
+    return bad;
+}
+
+// scaleInto() matches drawing each scaled pixel, clipped, over whatever
+// the destination held
+static int checkScale(void) {
+    int bad = 0;
+
+    srand(30);
+    for(uint16_t trial=0; trial<400; trial++) {
+        int16_t w  = 1 + rand() % 40, h  = 1 + rand() % 12,
+                dw = 1 + rand() % 90, dh = 1 + rand() % 40,
+                x0 = rand() % 60 - 20, y0 = rand() % 30 - 10, x, y;
+        uint8_t s  = 1 + rand() % 4;
+        GFXcanvas1  a(w, h), a2(dw, dh), a3(dw, dh);
+        GFXcanvas8  b(w, h), b2(dw, dh), b3(dw, dh);
+        GFXcanvas16 c(w, h), c2(dw, dh), c3(dw, dh);
+        for(y=0; y<h; y++) {
+            for(x=0; x<w; x++) {
+                int p = rand();
+                a.drawPixel(x, y, p & 1);
+                b.drawPixel(x, y, p & 0xFF);
+                c.drawPixel(x, y, p);
+            }
+        }
+        for(y=0; y<dh; y++) {
+            for(x=0; x<dw; x++) {
+                int p = rand() >> 8;
+                a2.drawPixel(x, y, p & 1);
+                a3.drawPixel(x, y, p & 1);
+                b2.drawPixel(x, y, p & 0xFF);
+                b3.drawPixel(x, y, p & 0xFF);
+                c2.drawPixel(x, y, p);
+                c3.drawPixel(x, y, p);
+            }
+        }
+        for(y=0; y<h * s; y++) {
+            for(x=0; x<w * s; x++) {
+                a3.drawPixel(x0 + x, y0 + y, get1(&a, x / s, y / s));
+                b3.drawPixel(x0 + x, y0 + y, b.getBuffer()[y / s * w + x / s]);
+                c3.drawPixel(x0 + x, y0 + y, c.getBuffer()[y / s * w + x / s]);
+            }
+        }
+        a.scaleInto(&a2, x0, y0, s);
+        b.scaleInto(&b2, x0, y0, s);
+        c.scaleInto(&c2, x0, y0, s);
+        for(y=0; y<dh; y++) {
+            for(x=0; x<dw; x++) {
+                if((get1(&a2, x, y) != get1(&a3, x, y)) ||
+                  (b2.getBuffer()[y * dw + x] != b3.getBuffer()[y * dw + x]) ||
+                  (c2.getBuffer()[y * dw + x] != c3.getBuffer()[y * dw + x])) {
+                    printf("  %dx%d at %d,%d x%u into %dx%d differs\n",
+                      w, h, x0, y0, s, dw, dh);
+                    bad++;
+                    y = dh;
+                    break;
+                }
+            }
+        }
+    }
+    return bad;
+}
+
+// Mirroring -------------------------------------------------------------
+
+// GFXmirror's frames, behind a GFXA header, play back through
+// GFXanimation to the buffer they were made from
+static int checkMirror(void) {
+    static const uint8_t header[] = {
+      'G', 'F', 'X', 'A', 1, 128, 4, 0, 1, 0, 0, 0
+    };
+    uint8_t   page[512], rx[512];
+    GFXmirror mirror;
+    int       bad = 0, keys = 0;
+    long      bytes = 0;
+
+    if(!mirror.begin(128, 4)) return 1;
+    memset(rx, 0x55, sizeof(rx));
+    srand(48);
+    for(uint16_t f=0; f<300; f++) {
+        if(!(f % 50)) memset(page, rand(), sizeof(page));
+        for(uint8_t i=rand() % 6; i; i--) page[rand() % 512] ^= 1 << (rand() % 8);
+        if(!(f % 97)) for(uint16_t i=0; i<512; i++) page[i] = rand();
+        if(f == 150) mirror.reset();
+
+        StringPrint stream;
+        uint16_t    n = mirror.frameSize(page);
+        stream.s.assign((const char *)header, sizeof(header));
+        if((mirror.writeFrame(page, &stream) != n) ||
+          (n && (stream.s.size() != sizeof(header) + n))) {
+            printf("  frame %u: size %u, wrote %u\n", f, n,
+              (unsigned)(stream.s.size() - sizeof(header)));
+            bad++;
+        }
+        if(n) {
+            GFXanimation anim;
+            if(!stream.s[sizeof(header)]) keys++;
+            bytes += n;
+            if(!anim.begin((uint8_t *)&stream.s[0], stream.s.size(), rx)) bad++;
+            anim.nextFrame();
+        }
+        if(memcmp(rx, page, sizeof(page))) {
+            printf("  frame %u plays back wrong\n", f);
+            bad++;
+        }
+    }
+    printf("  %d keyframes, %ld bytes per frame\n", keys, bytes / 300);
+    return bad;
+}
+
+// GFXcounter ------------------------------------------------------------
+
+static int flushes;
+static void countFlush(void) { flushes++; }
+
+static void counterScene(Adafruit_GFX *g) {
+    g->fillScreen(0);
+    g->fillRect(114, 5, 4, 3, 1);
+    g->drawRect(119, 3, 4, 5, 1);
+    g->drawLine(0, 0, 50, 20, 1);
+    g->drawCircle(60, 16, 10, 1);
+    g->fillCircle(-3, 30, 8, 1);
+    g->setTextColor(1);
+    g->setTextSize(2);
+    g->setCursor(3, 12);
+    g->print("Team 1-1");
+}
+
+// Drawing through the counter changes nothing, and rects are counted
+// once each with their clipped area
+static int checkCounter(void) {
+    GFXcanvas1 a(128, 32), b(128, 32);
+    GFXcounter c(&a, countFlush);
+    int        bad = 0;
+
+    counterScene(&c);
+    counterScene(&b);
+    if(memcmp(a.getBuffer(), b.getBuffer(), 16 * 32)) bad++;
+    flushes = 0;
+    c.display();
+    if((flushes != 1) || (c.getCalls(GFX_COUNT_FLUSH) != 1)) bad++;
+
+    c.reset();
+    c.trackOverdraw(true);
+    c.setRotation(1);
+    c.fillRect(0, 0, 32, 128, 1);
+    c.fillRect(-5, -5, 10, 10, 1);
+    if((c.width() != 32) || (c.height() != 128) ||
+      (c.getCalls(GFX_COUNT_RECT) != 2) ||
+      (c.getPixels() != 32 * 128 + 25) || (c.getOverdraw() != 25)) {
+        printf("  %u rects, %u pixels, %u overdrawn\n",
+          c.getCalls(GFX_COUNT_RECT), c.getPixels(), c.getOverdraw());
+        bad++;
+    }
+    return bad;
+}
+
+// QR codes ----------------------------------------------------------------
+
+// Symbols made by another encoder (node's qrcode-terminal, whose mask
+// numbers are the same) for a fixed mask, row by row, MSB first
+static const struct {
+  const char *text;    // NULL: the 250-byte test string below
+  uint8_t     ecc, mask, version;
+  const char *modules; // Hex
+} qrKnown[] = {
+  { "WIFI:S:badge;;", GFX_QR_ECC_MEDIUM, 3, 1,
+      "FE83FC16D06E90BB75B5DBA72EC12107FAAFE01900B76A5A0F8C38CC4719709B"
+      "B43B0065CFFA8290579DBA4055D54DAEAE19049D9FEB6600" },
+  { NULL, GFX_QR_ECC_LOW, 5, 10,
+      "FE7DE8FE3E3F3FC13990DA97F6906E87622EBAA9CBB752DF5BD3F3A5DBA88833"
+      "FC4ED2EC10859319EED107FAAAAAAAAAAAFE00CF0E47153100C75C28BF1A660C"
+      "4A23C7F3B3B371B1F4553FB1C9CBDEA5B2B86E8FF471B3E166CACAD6C522A1A4"
+      "3687EC0BEE4F79522CAC95B3F184EECCBBACFA64E5323B5673CAC5B9C12C38E3"
+      "DACA534B74561CE23D4C03B91347C6FEE65A13864E7587D6A5F5B5BFF2D9C836"
+      "A9D6514108F4F5216174A5D751E3EEFAFB2D243EAAFF2A3E6C4BFA0AFFD3AABE"
+      "C31FBE245E58F15EA8CB22B5E30A894593871E4F0C523F20E9FE94B7F3295129"
+      "CFFDEA6FCF48E4107D10D378EFFCDFF3F17EB5DDAAD8AA428083B515D93E9FC7"
+      "E5737ABE4D8D9A42CECE082869211F7FEED90A940117B8865EE8A3C755BB2129"
+      "7F2844080868A96BA4B2DA60A741D4893A4C248BF2B24475296325DD4253B566"
+      "432305F4E7D7DDC69E1D48DFF9FB5DF256F3F1B98ECC022F273FAFAFFB806B83"
+      "F14A3EC57FB35E3A98112B105E79244E8AD1CBA6821FF0A67F95D070C7F4E5AF"
+      "C2E9EADA76744BF70548B1D68A9B14FEAEA9116C036500" }
+};
+
+static GFXqrcode qr, qr2; // Too big for the stack on the badge, so here too
+
+// drawPaged() of the symbol in 'qr' against draw() with light modules
+// set, at scales 1 and 2, placed to be clipped on each side in turn
+static int qrPaged(uint8_t version) {
+    static const int16_t at[][2] = { { 3, 2 }, { -7, -5 }, { 90, 30 } };
+    int                  bad     = 0;
+
+    for(uint8_t scale=1; scale<=2; scale++) {
+        for(uint8_t a=0; a<sizeof(at) / sizeof(at[0]); a++) {
+            GFXcanvas1 c(128, 64);
+            uint8_t    page[128 * 8];
+            uint16_t   diff = 0;
+            memset(page, 0, sizeof(page));
+            qr.draw(&c, at[a][0], at[a][1], scale, 0, 1, 4);
+            qr.drawPaged(page, 128, 64, at[a][0], at[a][1], scale, 4);
+            for(int16_t y=0; y<64; y++) {
+                for(int16_t x=0; x<128; x++) {
+                    diff += get1(&c, x, y) !=
+                      ((page[(y >> 3) * 128 + x] >> (y & 7)) & 1);
+                }
+            }
+            if(diff) {
+                printf("  version %u x%u at %d,%d: drawPaged() differs by "
+                  "%u pixels\n", version, scale, at[a][0], at[a][1], diff);
+                bad++;
+            }
+        }
+    }
+    return bad;
+}
+
+static int checkQR(void) {
+    char text[251];
+    int  bad = 0;
+
+    for(uint8_t i=0; i<250; i++) text[i] = 33 + i * 7 % 90;
+    text[250] = 0;
+    for(uint8_t k=0; k<sizeof(qrKnown) / sizeof(qrKnown[0]); k++) {
+        const char *t = qrKnown[k].text ? qrKnown[k].text : text;
+        if(!qr.encode(t, qrKnown[k].ecc, qrKnown[k].mask) ||
+          (qr.getVersion() != qrKnown[k].version) ||
+          (qr.getMask() != qrKnown[k].mask)) {
+            printf("  version %u: not encoded as such\n", qrKnown[k].version);
+            bad++;
+            continue;
+        }
+        uint8_t  size = qr.getSize();
+        uint16_t diff = 0;
+        for(uint16_t i=0; i<size * size; i++) {
+            char    hex[3] = { qrKnown[k].modules[i / 8 * 2],
+                               qrKnown[k].modules[i / 8 * 2 + 1], 0 };
+            uint8_t byte   = strtoul(hex, NULL, 16);
+            diff += qr.getModule(i % size, i / size) !=
+              ((byte >> (7 - (i & 7))) & 1);
+        }
+        if(diff) {
+            printf("  version %u: %u modules differ\n", qrKnown[k].version, diff);
+            bad++;
+        }
+        // The automatic mask is one of the eight, applied the same way
+        if(!qr.encode(t, qrKnown[k].ecc) ||
+          !qr2.encode(t, qrKnown[k].ecc, qr.getMask())) {
+            bad++;
+            continue;
+        }
+        for(uint16_t i=0; i<size * size; i++) {
+            if(qr.getModule(i % size, i / size) != qr2.getModule(i % size, i / size)) {
+                printf("  version %u: automatic mask %u differs\n",
+                  qrKnown[k].version, qr.getMask());
+                bad++;
+                break;
+            }
+        }
+        bad += qrPaged(qrKnown[k].version);
+    }
+    return bad;
+}
+
+// GFXtextLayout ---------------------------------------------------------
+
+// Rightmost pixel of each laid out line, drawn alone, must be inside the
+// layout width (a word is only split when it's wider than a line)
+static int layoutFits(const char *str, int16_t width) {
+    GFXcanvas1    c(200, 24);
+    GFXtextLayout layout;
+    int           bad = 0;
+
+    c.setFont(&FreeSans9pt7b);
+    c.setTextColor(1);
+    for(uint16_t l=0; l<layout.layout(&c, str, width); l++) {
+        int16_t right = -1;
+        c.fillScreen(0);
+        layout.drawLines(0, 16, l, 1);
+        for(int16_t y=0; y<c.height(); y++) {
+            for(int16_t x=right+1; x<c.width(); x++) if(get1(&c, x, y)) right = x;
+        }
+        if(right >= width) {
+            printf("  \"%s\" line %u: %d wide, over %d\n", str, l, right + 1,
+              width);
+            bad++;
+        }
+    }
+    return bad;
+}
+
+static int checkLayout(void) {
+    GFXcanvas1    c(8, 8);
+    GFXtextLayout layout;
+    char          text[] = "WWWW WWWW";
+    int           bad    = layoutFits("i WWWWWWWW", 60) +
+      layoutFits("a b WWWWWWW c", 60) + layoutFits("Mid-word WWWWWWWWWWWWW", 90);
+
+    // The same buffer, rewritten in place, must be laid out again; and a
+    // copy elsewhere gives the same lines
+    c.setFont(&FreeSans9pt7b);
+    uint16_t before = layout.layout(&c, text, 80);
+    strcpy(text, "i i i i i");
+    uint16_t after = layout.layout(&c, text, 80),
+             again = layout.layout(&c, "i i i i i", 80);
+    if((before != 2) || (after != 1) || (again != 1)) {
+        printf("  rewritten string: %u, %u, %u lines\n", before, after, again);
+        bad++;
+    }
+    return bad;
+}
+
+// GFXimageFile, GFXfontFile ---------------------------------------------
+
+#define IMG_W 13 // Odd sizes, so rows are padded and the last band is short
+#define IMG_H 11
+
+static boolean imgLit(int16_t x, int16_t y) {
+    return ((x * 3 + y * 5) % 7) < 3;
+}
+
+static void put16(std::string &s, uint16_t v) {
+    s += (char)v;
+    s += (char)(v >> 8);
+}
+
+static void put32(std::string &s, uint32_t v) {
+    put16(s, v);
+    put16(s, v >> 16);
+}
+
+// Binary PBM of the test image, with a header comment
+static std::string imgPBM(void) {
+    std::string s = "P4\n# test\n" + std::to_string(IMG_W) + " " +
+      std::to_string(IMG_H) + "\n";
+    for(int16_t y=0; y<IMG_H; y++) {
+        for(int16_t x=0; x<IMG_W; x+=8) {
+            uint8_t b = 0;
+            for(int16_t i=0; i<8; i++) {
+                if((x + i < IMG_W) && !imgLit(x + i, y)) b |= 0x80 >> i;
+            }
+            s += (char)b;
+        }
+    }
+    return s;
+}
+
+// BMP of the test image: 1 bit with a white-then-black palette stored
+// top-down, or 24 bit stored bottom-up
+static std::string imgBMP(uint8_t bpp) {
+    uint32_t    stride = (IMG_W * bpp + 31) / 32 * 4,
+                data   = 14 + 40 + ((bpp == 1) ? 8 : 0);
+    std::string s      = "BM";
+
+    put32(s, data + stride * IMG_H);
+    put32(s, 0);
+    put32(s, data);
+    put32(s, 40);                                   // BITMAPINFOHEADER
+    put32(s, IMG_W);
+    put32(s, (bpp == 1) ? -IMG_H : IMG_H);
+    put16(s, 1);
+    put16(s, bpp);
+    for(uint8_t i=0; i<6; i++) put32(s, 0);         // BI_RGB, sizes...
+    if(bpp == 1) {
+        put32(s, 0xFFFFFF);
+        put32(s, 0);
+    }
+    for(int16_t r=0; r<IMG_H; r++) {
+        int16_t     y = (bpp == 1) ? r : IMG_H - 1 - r;
+        std::string row(stride, 0);
+        for(int16_t x=0; x<IMG_W; x++) {
+            if(bpp == 1) {
+                if(!imgLit(x, y)) row[x / 8] |= 0x80 >> (x & 7);
+            } else if(imgLit(x, y)) {
+                row.replace(x * 3, 3, 3, (char)0xFF);
+            }
+        }
+        s += row;
+    }
+    return s;
+}
+
+// Draw 'path' at each offset into a canvas and a page buffer, both
+// larger than the image and pre-filled with a pattern that must survive
+// around it
+static int checkImage(const char *path) {
+    static const int16_t at[][2] = { { 0, 0 }, { -5, -3 }, { 7, 9 }, { -12, 6 } };
+    GFXimageFile img;
+    int          bad = 0;
+
+    if(!img.begin(SPIFFS, path) || (img.width() != IMG_W) ||
+       (img.height() != IMG_H)) {
+        printf("  %s: not read as %dx%d\n", path, IMG_W, IMG_H);
+        return 1;
+    }
+    for(uint8_t a=0; a<sizeof(at) / sizeof(at[0]); a++) {
+        GFXcanvas1 c(24, 24);
+        uint8_t    page[24 * 3];
+        int16_t    x0 = at[a][0], y0 = at[a][1], x, y, diff = 0;
+        for(y=0; y<24; y++) {
+            for(x=0; x<24; x++) c.drawPixel(x, y, (x ^ y) & 1);
+        }
+        memset(page, 0xA5, sizeof(page));
+        if(!img.draw(&c, x0, y0, 1, 0) ||
+           !img.drawPaged(page, 24, 24, x0, y0)) {
+            printf("  %s at %d,%d: draw failed\n", path, x0, y0);
+            bad++;
+            continue;
+        }
+        for(y=0; y<24; y++) {
+            for(x=0; x<24; x++) {
+                boolean in   = (x >= x0) && (x < x0 + IMG_W) &&
+                               (y >= y0) && (y < y0 + IMG_H);
+                uint8_t want = in ? imgLit(x - x0, y - y0) : (x ^ y) & 1,
+                        pw   = in ? want : (0xA5 >> (y & 7)) & 1;
+                diff += (get1(&c, x, y) != want) +
+                  (((page[(y >> 3) * 24 + x] >> (y & 7)) & 1) != pw);
+            }
+        }
+        if(diff) {
+            printf("  %s at %d,%d: %d pixels differ\n", path, x0, y0, diff);
+            bad++;
+        }
+    }
+    // Rows stored top-down are read without seeking back
+    long seeks = fs::File::seeks;
+    GFXcanvas1 c(IMG_W, IMG_H);
+    img.draw(&c, 0, 0, 1, 0);
+    if(strstr(path, "24") ? (fs::File::seeks - seeks != IMG_H) :
+       (fs::File::seeks - seeks > 1)) {
+        printf("  %s: %ld seeks\n", path, fs::File::seeks - seeks);
+        bad++;
+    }
+    img.end();
+    return bad;
+}
+
+static int checkImageFile(void) {
+    GFXimageFile img;
+    std::string  cut;
+
+    SPIFFS.files["/img.pbm"]   = imgPBM();
+    SPIFFS.files["/img1.bmp"]  = imgBMP(1);
+    SPIFFS.files["/img24.bmp"] = imgBMP(24);
+    cut = SPIFFS.files["/img24.bmp"];
+    SPIFFS.files["/cut.bmp"]   = cut.substr(0, cut.size() - 1);
+    int bad = checkImage("/img.pbm") + checkImage("/img1.bmp") +
+      checkImage("/img24.bmp");
+    if(img.begin(SPIFFS, "/cut.bmp") || img.begin(SPIFFS, "/none.bmp")) {
+        printf("  truncated or missing file accepted\n");
+        bad++;
+    }
+    SPIFFS.files.clear();
+    return bad;
+}
+
+// FreeSans9pt7b as written by 'fontconvert -b', and (cut short) damaged
+static int checkFontFile(void) {
+    const GFXfont *f     = &FreeSans9pt7b;
+    uint16_t       count = f->last - f->first + 1, i, maxLen = 0;
+    uint32_t       size  = 0;
+    std::string    glyphs, file = "GFXF";
+    GFXfontFile    font;
+    GFXcanvas1     a(160, 24), b(160, 24);
+    int            bad = 0;
+
+    for(i=0; i<count; i++) {
+        const GFXglyph *g = &f->glyph[i];
+        uint16_t len = (g->width * g->height + 7) / 8;
+        put16(glyphs, g->bitmapOffset);
+        put16(glyphs, len);
+        glyphs += (char)g->width;
+        glyphs += (char)g->height;
+        glyphs += (char)g->xAdvance;
+        glyphs += (char)g->xOffset;
+        glyphs += (char)g->yOffset;
+        if(len > maxLen) maxLen = len;
+        if(g->bitmapOffset + len > size) size = g->bitmapOffset + len;
+    }
+    file += (char)GFX_FONT_FILE_VERSION;
+    file += (char)0;
+    file += (char)f->first;
+    file += (char)f->last;
+    file += (char)f->yAdvance;
+    file += (char)0;
+    put16(file, count);
+    put16(file, 0);
+    put16(file, maxLen);
+    put32(file, size);
+    file += glyphs + std::string((const char *)f->bitmap, size);
+    SPIFFS.files["/font.fnt"] = file;
+    SPIFFS.files["/cut.fnt"]  = file.substr(0, 20 + 9 * count - 1);
+
+    // A tiny cache, so glyphs are evicted and read again
+    if(!font.begin(SPIFFS, "/font.fnt", 64)) {
+        printf("  font file not loaded\n");
+        bad++;
+    } else {
+        a.setFont(f);
+        b.setFontSource(&font);
+        for(GFXcanvas1 *c=&a; c; c=(c == &a) ? &b : NULL) {
+            c->setTextColor(1);
+            c->setCursor(0, 16);
+            c->print("Badge 0123 gjpqy! Badge");
+        }
+        if(memcmp(a.getBuffer(), b.getBuffer(), 20 * 24)) {
+            printf("  text from the font file differs\n");
+            bad++;
+        }
+        b.setFontSource(NULL);
+    }
+    GFXfontFile cut;
+    if(cut.begin(SPIFFS, "/cut.fnt")) {
+        printf("  truncated font file accepted\n");
+        bad++;
+    }
+    SPIFFS.files.clear();
+    return bad;
+}
+
+void addChecks(std::vector<Check> &list) {
+    static const Check checks[] = {
+      { "spitft_fill", checkFill    },
+      { "rotate_into", checkRotate  },
+      { "scale_into",  checkScale   },
+      { "mirror",      checkMirror  },
+      { "counter",     checkCounter },
+      { "qrcode",      checkQR      },
+      { "text_layout", checkLayout  },
+      { "image_file",  checkImageFile },
+      { "font_file",   checkFontFile  }
+    };
+    list.assign(checks, checks + sizeof(checks) / sizeof(checks[0]));
+}
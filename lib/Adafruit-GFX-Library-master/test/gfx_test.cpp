@@ -0,0 +1,263 @@
+// Host regression harness: renders each scene, compares it with its
+// golden image and times it against the baseline, then runs the checks.
+//
+//   gfx_test [--golden] [--strict-perf] [name...]
+//
+// --golden rewrites the golden images and baseline times of the scenes
+// run, from this build, instead of comparing.  Names (or parts of names)
+// pick the scenes and checks to run.  Exits non-zero on any pixel
+// difference or failed check; slower scenes are only reported, unless
+// --strict-perf.
+
+#include "gfx_test.h"
+#include <map>
+#include <time.h>
+#include <sys/stat.h>
+
+// Scenes costing this many times their baseline are flagged, ignoring
+// differences under PERF_SLACK (timer and cache noise on tiny scenes).
+// Costs are in thousandths of the calibration loop, see timeScene().
+#ifndef PERF_LIMIT
+#define PERF_LIMIT 2.0
+#endif
+#ifndef PERF_SLACK
+#define PERF_SLACK 20.0
+#endif
+
+#define GOLDEN_DIR "golden/"
+#define OUT_DIR    "out/"
+#define BASELINE   GOLDEN_DIR "baseline.txt"
+
+static std::string render(const Scene &s) {
+    StringPrint out;
+    if(s.depth == 16) {
+        GFXcanvas16 c(s.w, s.h);
+        s.draw(&c, s.arg);
+        c.writePPM(&out);
+    } else {
+        GFXcanvas1 c(s.w, s.h);
+        s.draw(&c, s.arg);
+        c.writePBM(&out);
+    }
+    return out.s;
+}
+
+// Process CPU time in microseconds, less disturbed than micros() by
+// whatever else the host is doing
+static double cpuMicros(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &t);
+    return t.tv_sec * 1e6 + t.tv_nsec / 1e3;
+}
+
+// Microseconds taken by 'fn', the best of a few runs of at least 'min' us
+template<typename F> static double timeRuns(F fn, double min) {
+    double best = 1e30;
+    for(uint8_t run=0; run<3; run++) {
+        double   t0 = cpuMicros(), t;
+        uint32_t n  = 0;
+        do {
+            fn();
+            n++;
+        } while((t = cpuMicros() - t0) < min);
+        if(t / n < best) best = t / n;
+    }
+    return best;
+}
+
+// A fixed amount of work that doesn't touch the library, timed alongside
+// each scene so that its cost can be given relative to it
+static volatile uint32_t calibrationSink;
+
+static void calibration(void) {
+    static uint32_t buf[4096];
+    uint32_t        x = 1;
+    for(uint32_t i=0; i<100000; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        buf[x & 4095] += x;
+    }
+    calibrationSink = buf[x & 4095];
+}
+
+// Microseconds per draw into 'g', a canvas made once beforehand, and the
+// cost: the time relative to the calibration loop, which holds steady
+// when the host speeds up or slows down (clock scaling, a busy VM), so
+// it's what is compared with the baseline.  Making the canvas and writing
+// the image are left out, as render() is only for the golden comparison.
+static void timeDraw(const Scene &s, Adafruit_GFX *g, double *us,
+  double *cost) {
+    double best = 1e30;
+    for(uint8_t run=0; run<3; run++) {
+        double c = timeRuns(calibration, 2000),
+               t = timeRuns([&s, g]() { s.draw(g, s.arg); }, 2000);
+        if(t / c < best) {
+            best = t / c;
+            *us  = t;
+        }
+    }
+    *cost = best * 1000;
+}
+
+static void timeScene(const Scene &s, double *us, double *cost) {
+    if(s.depth == 16) {
+        GFXcanvas16 c(s.w, s.h);
+        timeDraw(s, &c, us, cost);
+    } else {
+        GFXcanvas1 c(s.w, s.h);
+        timeDraw(s, &c, us, cost);
+    }
+}
+
+static boolean readFile(const std::string &path, std::string *data) {
+    FILE *f = fopen(path.c_str(), "rb");
+    if(!f) return false;
+    char   buf[4096];
+    size_t n;
+    data->clear();
+    while((n = fread(buf, 1, sizeof(buf), f)) > 0) data->append(buf, n);
+    fclose(f);
+    return true;
+}
+
+static boolean writeFile(const std::string &path, const std::string &data) {
+    FILE *f = fopen(path.c_str(), "wb");
+    if(!f) return false;
+    boolean ok = fwrite(data.data(), 1, data.size(), f) == data.size();
+    return !fclose(f) && ok;
+}
+
+// Pixels that differ between two images of the same format and size, or
+// -1 if they can't be compared
+static long pixelDiff(const std::string &a, const std::string &b,
+  uint8_t depth) {
+    if(a.size() != b.size()) return -1;
+    size_t header = a.find('\n', depth == 16 ? a.find("\n255") + 1 : 3) + 1;
+    if(a.compare(0, header, b, 0, header)) return -1;
+    long n = 0;
+    if(depth == 16) {
+        for(size_t i=header; i<a.size(); i+=3) n += a.compare(i, 3, b, i, 3) != 0;
+    } else {
+        for(size_t i=header; i<a.size(); i++) {
+            n += __builtin_popcount((uint8_t)(a[i] ^ b[i]));
+        }
+    }
+    return n;
+}
+
+// Baseline costs by scene name, from lines of: name cost
+static std::map<std::string, double> readBaseline(void) {
+    std::map<std::string, double> costs;
+    FILE  *f = fopen(BASELINE, "r");
+    char   name[128];
+    double cost;
+    if(f) {
+        while(fscanf(f, "%127s %lf", name, &cost) == 2) costs[name] = cost;
+        fclose(f);
+    }
+    return costs;
+}
+
+static boolean picked(const char *name, const std::vector<const char *> &pick) {
+    if(pick.empty()) return true;
+    for(size_t i=0; i<pick.size(); i++) if(strstr(name, pick[i])) return true;
+    return false;
+}
+
+int main(int argc, char *argv[]) {
+    boolean                  golden = false, strictPerf = false;
+    std::vector<const char *> pick;
+    std::vector<Scene>       scenes;
+    std::vector<Check>       checks;
+    int                      diffs = 0, slow = 0, failed = 0;
+
+    for(int i=1; i<argc; i++) {
+        if(!strcmp(argv[i], "--golden"))           golden     = true;
+        else if(!strcmp(argv[i], "--strict-perf")) strictPerf = true;
+        else pick.push_back(argv[i]);
+    }
+    addScenes(scenes);
+    addChecks(checks);
+
+    std::map<std::string, double> baseline = readBaseline();
+
+    for(size_t i=0; i<scenes.size(); i++) {
+        const Scene &s = scenes[i];
+        if(!picked(s.name.c_str(), pick)) continue;
+        std::string  ext = (s.depth == 16) ? ".ppm" : ".pbm",
+                     img = render(s), ref;
+        double       us, cost;
+
+        timeScene(s, &us, &cost);
+        if(golden) {
+            if(!writeFile(GOLDEN_DIR + s.name + ext, img)) {
+                printf("%-32s can't write golden image\n", s.name.c_str());
+                failed++;
+            }
+            baseline[s.name] = cost;
+            continue;
+        }
+
+        std::map<std::string, double>::iterator b = baseline.find(s.name);
+        // Time a slow scene again before believing it: the host may just
+        // have been busy
+        for(uint8_t retry=0; (b != baseline.end()) && (retry<3) &&
+          (cost > b->second * PERF_LIMIT); retry++) {
+            double us2, cost2;
+            timeScene(s, &us2, &cost2);
+            if(cost2 < cost) {
+                cost = cost2;
+                us   = us2;
+            }
+        }
+        printf("%-32s %9.2f us %8.1f", s.name.c_str(), us, cost);
+        if(b != baseline.end()) {
+            printf(" (baseline %8.1f)", b->second);
+            if((cost > b->second * PERF_LIMIT) &&
+              (cost - b->second > PERF_SLACK)) {
+                printf("  SLOWER");
+                slow++;
+            }
+        }
+        if(!readFile(GOLDEN_DIR + s.name + ext, &ref)) {
+            printf("  NO GOLDEN IMAGE");
+            diffs++;
+        } else if(ref != img) {
+            long n = pixelDiff(ref, img, s.depth);
+            if(n < 0) printf("  SIZE DIFFERS");
+            else      printf("  %ld PIXELS DIFFER", n);
+            mkdir(OUT_DIR, 0777);
+            writeFile(OUT_DIR + s.name + ext, img);
+            diffs++;
+        }
+        printf("\n");
+    }
+
+    if(golden) {
+        std::string text;
+        char        line[160];
+        for(size_t i=0; i<scenes.size(); i++) { // Corpus order
+            std::map<std::string, double>::iterator b =
+              baseline.find(scenes[i].name);
+            if(b == baseline.end()) continue;
+            snprintf(line, sizeof(line), "%s %.1f\n", b->first.c_str(), b->second);
+            text += line;
+        }
+        if(!writeFile(BASELINE, text)) failed++;
+        printf("Wrote golden images and " BASELINE "\n");
+        return failed ? 1 : 0;
+    }
+
+    for(size_t i=0; i<checks.size(); i++) {
+        if(!picked(checks[i].name, pick)) continue;
+        int bad = checks[i].run();
+        printf("check %-22s %s\n", checks[i].name, bad ? "FAILED" : "ok");
+        if(bad) failed++;
+    }
+
+    printf("\n%d image(s) differ, %d scene(s) slower, %d check(s) failed\n",
+      diffs, slow, failed);
+    if(diffs) printf("Differing images are in " OUT_DIR "\n");
+    return (diffs || failed || (strictPerf && slow)) ? 1 : 0;
+}
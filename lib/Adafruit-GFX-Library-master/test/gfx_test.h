@@ -0,0 +1,39 @@
+// Host regression harness for the GFX library, see Makefile.
+//
+// A scene draws into a fresh canvas, which is compared with its golden
+// image (golden/<name>.pbm or .ppm); the drawing alone is timed, over
+// and over on one canvas, against golden/baseline.txt.
+// A check is a pass/fail test of something a picture doesn't show.
+
+#ifndef _GFX_TEST_H_
+#define _GFX_TEST_H_
+
+#include <vector>
+#include <string>
+#include "Adafruit_GFX.h"
+
+struct Scene {
+  std::string name;
+  uint16_t    w, h;
+  uint8_t     depth;                     // 1 (PBM) or 16 (PPM)
+  void      (*draw)(Adafruit_GFX *g, int arg);
+  int         arg;
+};
+
+struct Check {
+  const char *name;
+  int       (*run)(void);                // Number of failures
+};
+
+// Print that collects output, e.g. for writePBM()
+class StringPrint : public Print {
+ public:
+  std::string s;
+  size_t write(uint8_t c) { s += (char)c; return 1; }
+  using Print::write;
+};
+
+void addScenes(std::vector<Scene> &list);
+void addChecks(std::vector<Check> &list);
+
+#endif // _GFX_TEST_H_
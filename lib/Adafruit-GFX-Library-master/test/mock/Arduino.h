@@ -0,0 +1,54 @@
+// Just enough of the Arduino core to build the library on the host.
+// PROGMEM is ordinary memory here, as on the ESP8266.  ARDUINO is
+// defined by the Makefile, since the library tests it before including
+// this.
+
+#ifndef _MOCK_ARDUINO_H
+#define _MOCK_ARDUINO_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+
+typedef bool    boolean;
+typedef uint8_t byte;
+
+class __FlashStringHelper;
+#define F(s)   ((const __FlashStringHelper *)(s))
+#define PSTR(s) (s)
+
+#define PROGMEM
+#define PGM_P               const char *
+#define pgm_read_byte(a)    (*(const uint8_t *)(a))
+#define pgm_read_word(a)    mockRead<uint16_t>(a)
+#define pgm_read_dword(a)   mockRead<unsigned long>(a) // Pointer-sized
+
+template<typename T> inline T mockRead(const void *a) {
+  T v;
+  memcpy(&v, a, sizeof(v));
+  return v;
+}
+#define memcpy_P            memcpy
+#define strlen_P            strlen
+
+#define OUTPUT    1
+#define INPUT     0
+#define LOW       0
+#define HIGH      1
+#define MSBFIRST  1
+#define SPI_MODE0 0
+
+#define constrain(x, a, b) ((x) < (a) ? (a) : ((x) > (b) ? (b) : (x)))
+
+inline void pinMode(int, int)          { }
+inline void digitalWrite(int, int)     { }
+inline int  digitalRead(int)           { return 0; }
+inline void delay(unsigned long)       { }
+unsigned long micros(void);            // Real time, in mock.cpp
+unsigned long millis(void);
+
+#include "Print.h"
+
+#endif // _MOCK_ARDUINO_H
@@ -0,0 +1,59 @@
+// ESP8266-style file system held in memory: checks put file contents in
+// SPIFFS.files, and File::seeks counts the seek() calls made.
+
+#ifndef _MOCK_FS_H
+#define _MOCK_FS_H
+
+#include <stdint.h>
+#include <map>
+#include <string>
+
+namespace fs {
+
+enum SeekMode { SeekSet, SeekCur, SeekEnd };
+
+class File {
+ public:
+  static long seeks;
+
+  File(const std::string *d=NULL) : data(d), pos(0) { }
+  operator bool() const       { return data != NULL; }
+  size_t position(void) const { return pos; }
+  size_t size(void) const     { return data ? data->size() : 0; }
+  void   close(void)          { data = NULL; }
+  int    read(void) {
+    return (pos < size()) ? (uint8_t)(*data)[pos++] : -1;
+  }
+  size_t read(uint8_t *buf, size_t n) {
+    if(n > size() - pos) n = size() - pos;
+    if(n) data->copy((char *)buf, n, pos);
+    pos += n;
+    return n;
+  }
+  bool   seek(uint32_t p, SeekMode mode=SeekSet) {
+    size_t to = p + ((mode == SeekCur) ? pos : (mode == SeekEnd) ? size() : 0);
+    seeks++;
+    if(!data || (to > size())) return false;
+    pos = to;
+    return true;
+  }
+ private:
+  const std::string *data;
+  size_t             pos;
+};
+
+class FS {
+ public:
+  std::map<std::string, std::string> files;
+
+  File open(const char *path, const char *) {
+    std::map<std::string, std::string>::iterator f = files.find(path);
+    return File((f == files.end()) ? NULL : &f->second);
+  }
+};
+
+} // namespace fs
+
+extern fs::FS SPIFFS;
+
+#endif // _MOCK_FS_H
@@ -0,0 +1,43 @@
+// Arduino Print, less the floating point and base conversions
+
+#ifndef _MOCK_PRINT_H
+#define _MOCK_PRINT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+class __FlashStringHelper;
+
+class Print {
+ public:
+  virtual ~Print() { }
+  virtual size_t write(uint8_t) = 0;
+  virtual size_t write(const uint8_t *buf, size_t n) {
+    size_t r = 0;
+    while(n--) r += write(*buf++);
+    return r;
+  }
+  size_t write(const char *s) { return write((const uint8_t *)s, strlen(s)); }
+
+  size_t print(const char *s)                { return write(s); }
+  size_t print(const __FlashStringHelper *s) { return write((const char *)s); }
+  size_t print(char c)                       { return write((uint8_t)c); }
+  size_t print(long n) {
+    char b[24];
+    snprintf(b, sizeof(b), "%ld", n);
+    return write(b);
+  }
+  size_t print(unsigned long n) {
+    char b[24];
+    snprintf(b, sizeof(b), "%lu", n);
+    return write(b);
+  }
+  size_t print(int n)          { return print((long)n); }
+  size_t print(unsigned int n) { return print((unsigned long)n); }
+  size_t println(void)         { return write("\n"); }
+  template<typename T> size_t println(T v) { return print(v) + println(); }
+};
+
+#endif // _MOCK_PRINT_H
@@ -0,0 +1,50 @@
+// ESP8266-style SPI that records what is sent: the number of calls into
+// the driver ('transactions') and every byte, for checking fills.
+
+#ifndef _MOCK_SPI_H
+#define _MOCK_SPI_H
+
+#include <stdint.h>
+#include <vector>
+
+#define SPI_HAS_TRANSACTION
+
+struct SPISettings {
+  SPISettings(uint32_t, uint8_t, uint8_t) { }
+};
+
+class SPIClass {
+ public:
+  uint32_t             transactions;
+  std::vector<uint8_t> sent;
+
+  SPIClass() : transactions(0) { }
+  void    begin(void)                { }
+  void    beginTransaction(SPISettings) { }
+  void    endTransaction(void)       { }
+  void    setFrequency(uint32_t)     { }
+  void    reset(void)                { transactions = 0; sent.clear(); }
+  uint8_t transfer(uint8_t b)        { write(b); return 0; }
+  void    write(uint8_t b)           { transactions++; sent.push_back(b); }
+  void    write16(uint16_t w) {
+    transactions++;
+    sent.push_back(w >> 8);
+    sent.push_back(w);
+  }
+  void    write32(uint32_t l) {
+    transactions++;
+    for(int8_t s=24; s>=0; s-=8) sent.push_back(l >> s);
+  }
+  void    writeBytes(const uint8_t *d, uint32_t n) {
+    transactions++;
+    sent.insert(sent.end(), d, d + n);
+  }
+  void    writePattern(const uint8_t *d, uint8_t size, uint32_t repeat) {
+    transactions++;
+    while(repeat--) sent.insert(sent.end(), d, d + size);
+  }
+};
+
+extern SPIClass SPI;
+
+#endif // _MOCK_SPI_H
@@ -0,0 +1,20 @@
+#include "Arduino.h"
+#include "SPI.h"
+#include "FS.h"
+#include <chrono>
+
+SPIClass SPI;
+fs::FS   SPIFFS;
+long     fs::File::seeks;
+
+static std::chrono::steady_clock::time_point start =
+  std::chrono::steady_clock::now();
+
+unsigned long micros(void) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+      std::chrono::steady_clock::now() - start).count();
+}
+
+unsigned long millis(void) {
+    return micros() / 1000;
+}
@@ -0,0 +1 @@
+// Included by the library when built as ESP8266; Arduino.h has the rest
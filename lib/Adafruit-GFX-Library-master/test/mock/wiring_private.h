@@ -0,0 +1 @@
+// Included by Adafruit_SPITFT.cpp; nothing needed on the host
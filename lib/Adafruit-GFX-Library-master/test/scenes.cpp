@@ -0,0 +1,366 @@
+// The scene corpus: every primitive, at all four rotations, in 1-bit and
+// 16-bit; text in the classic and a GFX font at sizes 1 to 4; canvas
+// rotateInto() and scaleInto(); QR codes; GFXtextLayout; and a line in
+// each bundled font, as is and run-length encoded.
+// Changing what a scene draws means regenerating its golden image (make
+// golden), so add new scenes rather than edit.
+
+#include "gfx_test.h"
+#include "fonts.h"
+#include "GFXqrcode.h"
+#include "GFXtextLayout.h"
+
+static const uint8_t PROGMEM arrow[] = { // 16x8, 1 bit
+  0x00, 0x80, 0x00, 0xC0, 0xFF, 0xE0, 0xFF, 0xF0,
+  0xFF, 0xF0, 0xFF, 0xE0, 0x00, 0xC0, 0x00, 0x80
+};
+
+static const int16_t PROGMEM star[] = { // 5-point star, crossing edges
+  10, 0, 16, 19, 0, 7, 20, 7, 4, 19
+};
+
+static const char sample[] = "Badge 0123 gjpqy!";
+
+// Points on a circle, unit 1/64 of a turn, for drawing on any canvas
+static int16_t ring(int16_t c, int16_t r, int16_t i, boolean y) {
+    double a = i * (M_PI / 32);
+    return c + (int16_t)lround(r * (y ? sin(a) : cos(a)));
+}
+
+// Every primitive once, placed relative to the (rotated) canvas size and
+// partly off its edges, so the clipping paths are drawn too
+static void primitives(Adafruit_GFX *g, uint16_t fg, uint16_t bg) {
+    int16_t w = g->width(), h = g->height(), i;
+
+    g->drawPixel(0, 0, fg);
+    g->drawPixel(w - 1, h - 1, fg);
+    g->drawPixel(-1, 3, fg);
+    g->drawFastHLine(-5, 2, w + 10, fg);
+    g->drawFastVLine(2, -5, h + 10, fg);
+    g->drawLine(0, h - 1, w - 1, 4, fg);
+    g->drawLine(4, 4, 20, h - 4, fg);
+    g->drawLine(-10, h / 2, w + 10, h / 3, fg);
+    for(i=0; i<64; i+=5) {
+        g->drawLine(w / 4, h / 4, ring(w / 4, 14, i, false),
+          ring(h / 4, 14, i, true), fg);
+    }
+    g->drawRect(6, h - 20, 20, 12, fg);
+    g->fillRect(9, h - 17, 14, 6, fg);
+    g->fillRect(w - 12, h / 2, 20, 5, fg);
+    g->drawCircle(w / 2, h / 2, 12, fg);
+    g->drawCircle(w / 2, h / 2, 1, fg);
+    g->fillCircle(w - 10, 10, 7, fg);
+    g->fillCircle(-2, h - 2, 6, fg);
+    g->drawRoundRect(w / 2 - 14, 4, 28, 14, 4, fg);
+    g->fillRoundRect(w / 2 - 10, 7, 20, 8, 3, fg);
+    g->drawTriangle(w - 30, h - 4, w - 4, h - 20, w - 20, h - 30, fg);
+    g->fillTriangle(w / 3, h - 2, w / 3 + 12, h - 14, w / 3 + 20, h - 3, fg);
+    g->fillTriangle(w - 40, 2, w - 40, 2, w - 30, 2, fg); // Degenerate
+    g->drawPolygon(w - 26, h / 2 - 22, star, 5, fg);
+    g->fillPolygon(w / 2 + 14, h / 2 - 12, star, 5, fg, GFX_POLY_NONZERO);
+    g->fillPolygon(w / 2 - 34, h / 2 + 2, star, 5, fg, GFX_POLY_EVENODD);
+    g->drawBitmap(2, h / 2, arrow, 16, 8, fg);
+    g->drawBitmap(20, h / 2, arrow, 16, 8, fg, bg);
+    g->drawXBitmap(2, h / 2 + 10, arrow, 16, 8, fg);
+    g->drawRotatedBitmap(w / 2, h - 12, arrow, 16, 8, fg, 30);
+    g->drawRotatedBitmap(w - 16, h / 2 + 14, arrow, 16, 8, fg, 200, 0x18000);
+    g->drawChar(w - 12, h - 12, 'A', fg, bg, 1);
+}
+
+static void primitives1(Adafruit_GFX *g, int r) {
+    g->setRotation(r);
+    primitives(g, 1, 0);
+}
+
+static void primitives16(Adafruit_GFX *g, int r) {
+    GFXcanvas16 *c = (GFXcanvas16 *)g;
+    uint16_t     rgb[8 * 8];
+    uint8_t      gray[8 * 8], mask[8];
+
+    c->setRotation(r);
+    c->fillScreen(0x0010);
+    primitives(c, 0xFFE0, 0xF800);
+    for(uint8_t i=0; i<64; i++) {
+        rgb[i]  = ((i & 7) << 13) | ((i >> 3) << 8) | i;
+        gray[i] = i * 4;
+    }
+    memset(mask, 0xAA, sizeof(mask));
+    c->drawRGBBitmap(c->width() - 24, 20, rgb, 8, 8);
+    c->drawRGBBitmap(c->width() - 14, 20, rgb, mask, 8, 8);
+    c->drawGrayscaleBitmap(c->width() - 24, 30, gray, 8, 8);
+    c->drawRotatedRGBBitmap(c->width() / 3, c->height() / 3, rgb, 8, 8, 45);
+    c->fillRectAlpha(0, c->height() / 2 - 6, c->width(), 12, 0x07FF, 96);
+    c->drawAlphaMask(c->width() / 2, 30, gray, 8, 8, 0xF81F);
+}
+
+// Classic 5x7 font at size 'arg', wrapping, and a line of CP437
+static void textClassic(Adafruit_GFX *g, int size) {
+    g->setTextSize(size);
+    g->setTextColor(1);
+    g->setTextWrap(true);
+    g->setCursor(0, 0);
+    g->print(sample);
+    g->print("\nw");
+    g->setTextColor(0, 1);
+    g->print("rap");
+    g->cp437(true);
+    g->setTextColor(1);
+    g->setCursor(0, g->height() - 8 * size);
+    for(uint8_t c=0xB0; c<0xC0; c++) g->write(c);
+}
+
+// The same in a GFX font, with getTextBounds() boxed
+static void textFont(Adafruit_GFX *g, int size) {
+    int16_t  x1, y1;
+    uint16_t w, h;
+
+    g->setFont(&FreeSans9pt7b);
+    g->setTextSize(size);
+    g->setTextColor(1);
+    g->setTextWrap(true);
+    g->getTextBounds((char *)sample, 2, 13 * size, &x1, &y1, &w, &h);
+    g->drawRect(x1 - 1, y1 - 1, w + 2, h + 2, 1);
+    g->setCursor(2, 13 * size);
+    g->print(sample);
+    g->print("\nWrap");
+    g->setFont();
+}
+
+// 'sample' in bundled font number 'arg'
+static void fontLine(Adafruit_GFX *g, int n) {
+    int16_t  x1, y1;
+    uint16_t w, h;
+
+    g->setFont(testFonts[n].font);
+    g->setTextColor(1);
+    g->setTextWrap(false);
+    g->getTextBounds((char *)sample, 0, 0, &x1, &y1, &w, &h);
+    g->setCursor(1 - x1, 1 - y1);
+    g->print(sample);
+}
+
+// Bundled fonts re-encoded as GFX_FONT_RLE (as by 'fontconvert -r'), so
+// that raw and RLE drawing can be timed on the same glyphs; the images
+// must match the raw font's
+static std::vector<GFXfont>               rleFonts;
+static std::vector<std::vector<uint8_t> >  rleBitmaps;
+static std::vector<std::vector<GFXglyph> > rleGlyphs;
+
+static void nibble(std::vector<uint8_t> &out, boolean *hi, uint8_t n) {
+    if(*hi) out.push_back(n << 4);
+    else    out.back() |= n;
+    *hi = !*hi;
+}
+
+static void rleRun(std::vector<uint8_t> &out, boolean *hi, uint16_t run) {
+    for(; run >= 15; run -= 15) nibble(out, hi, 15);
+    nibble(out, hi, run);
+}
+
+// Encodes testFonts[n] into rleFonts[n]; the vectors must not grow after
+static void rleFont(uint8_t n) {
+    const GFXfont         *f      = testFonts[n].font;
+    std::vector<uint8_t>  &out    = rleBitmaps[n];
+    std::vector<GFXglyph> &glyphs = rleGlyphs[n];
+
+    for(uint16_t c=0; c<=f->last - f->first; c++) {
+        GFXglyph g    = f->glyph[c];
+        uint8_t *bits = &f->bitmap[g.bitmapOffset];
+        uint16_t run  = 0, pixels = g.width * g.height, i;
+        boolean  on   = false, hi = true;
+        g.bitmapOffset = out.size();
+        for(i=0; i<pixels; i++) {
+            if(!(bits[i / 8] & (0x80 >> (i & 7))) == !on) {
+                run++;
+            } else {
+                rleRun(out, &hi, run);
+                run = 1;
+                on  = !on;
+            }
+        }
+        if(pixels) rleRun(out, &hi, run); // A lone high nibble is 0-padded
+        glyphs.push_back(g);
+    }
+    rleFonts[n]        = *f;
+    rleFonts[n].bitmap = &out[0];
+    rleFonts[n].glyph  = &glyphs[0];
+    rleFonts[n].flags  = GFX_FONT_RLE;
+}
+
+static void fontLineRLE(Adafruit_GFX *g, int n) {
+    int16_t  x1, y1;
+    uint16_t w, h;
+
+    g->setFont(&rleFonts[n]);
+    g->setTextColor(1);
+    g->setTextWrap(false);
+    g->getTextBounds((char *)sample, 0, 0, &x1, &y1, &w, &h);
+    g->setCursor(1 - x1, 1 - y1);
+    g->print(sample);
+}
+
+// printOpaque() over a busy background, in a GFX font and the classic one
+static void opaqueText(Adafruit_GFX *g, int) {
+    for(int16_t x=0; x<g->width(); x+=3) g->drawFastVLine(x, 0, g->height(), 1);
+    g->setTextColor(1, 0);
+    g->setFont(&FreeMono9pt7b);
+    g->setCursor(2, 14);
+    g->printOpaque("Opaque", 100);
+    g->setFont();
+    g->setTextSize(2);
+    g->setCursor(2, 24);
+    g->printOpaque("5x7");
+}
+
+// A horizontal gray ramp in each dither mode
+static void dither(Adafruit_GFX *g, int) {
+    GFXcanvas1 *c = (GFXcanvas1 *)g;
+    uint8_t     ramp[64 * 16];
+
+    for(uint16_t i=0; i<sizeof(ramp); i++) ramp[i] = (i % 64) * 4 + (i / 64);
+    c->drawDitheredBitmap(0,  0, ramp, 64, 16, GFX_DITHER_THRESHOLD);
+    c->drawDitheredBitmap(0, 16, ramp, 64, 16, GFX_DITHER_BAYER);
+    c->drawDitheredBitmap(0, 32, ramp, 64, 16, GFX_DITHER_FLOYD);
+}
+
+// GFXtextLayout: a paragraph broken at spaces, mid-word and at a newline,
+// drawn without its first two and last two lines; or, for 'arg' 1, a
+// word that still doesn't fit once wrapped after its space.  The layout width is
+// marked on the right.
+static void textLayout(Adafruit_GFX *g, int arg) {
+    static const char para[] =
+      "Lines 1 and 2 are left out, then a longwordthatwontfitonaline "
+      "is split.\nAfter a newline, the last lines are left out too.";
+    GFXtextLayout layout;
+    int16_t       width = arg ? 60 : 120;
+
+    g->setFont(&FreeSans9pt7b);
+    g->setTextColor(1);
+    g->drawFastVLine(width, 0, g->height(), 1);
+    if(arg) {
+        layout.layout(g, "i WWWWWWWW", width);
+        layout.drawLines(0, 13, 0, layout.lines());
+    } else {
+        layout.layout(g, para, width);
+        layout.drawLines(0, 13, 2, layout.lines() - 4);
+    }
+    g->setFont();
+}
+
+// A QR code, encoded and drawn with a 4-module quiet zone at scale
+// 'arg' & 3: a version 3 ECC M symbol, or for 'arg' & 4 a version 10
+// ECC L one, each with the mask chosen automatically
+static void qrcode(Adafruit_GFX *g, int arg) {
+    static GFXqrcode qr; // Too big for the stack on the badge
+    char             text[251];
+
+    if(arg & 4) {
+        for(uint8_t i=0; i<250; i++) text[i] = 33 + i * 7 % 90;
+        text[250] = 0;
+        qr.encode(text, GFX_QR_ECC_LOW);
+    } else {
+        qr.encode("WIFI:S:badge-0123;T:WPA;P:secret;;", GFX_QR_ECC_MEDIUM);
+    }
+    qr.draw(g, 0, 0, arg & 3, 1, 0, 4);
+}
+
+// The unrotated primitives turned 'arg' quarter turns by rotateInto()
+static void rotated(Adafruit_GFX *g, int r) {
+    GFXcanvas1 src(128, 64);
+    primitives(&src, 1, 0);
+    src.rotateInto((GFXcanvas1 *)g, r);
+}
+
+static void rotated16(Adafruit_GFX *g, int r) {
+    GFXcanvas16 src(128, 64);
+    primitives16(&src, 0);
+    src.rotateInto((GFXcanvas16 *)g, r);
+}
+
+// Classic text drawn at size 1 and blown up 'arg' times by scaleInto()
+static void scaled(Adafruit_GFX *g, int s) {
+    GFXcanvas1 src(64, 16);
+    src.setCursor(0, 0);
+    src.setTextColor(1);
+    src.print("Scaled\nx");
+    src.print(s);
+    src.scaleInto((GFXcanvas1 *)g, 0, 0, s);
+}
+
+static void scaled16(Adafruit_GFX *g, int s) {
+    GFXcanvas16 src(48, 24);
+    primitives16(&src, 0);
+    src.scaleInto((GFXcanvas16 *)g, 0, 0, s);
+}
+
+static void add(std::vector<Scene> &list, const std::string &name,
+  uint16_t w, uint16_t h, uint8_t depth, void (*draw)(Adafruit_GFX *, int),
+  int arg) {
+    Scene s = { name, w, h, depth, draw, arg };
+    list.push_back(s);
+}
+
+void addScenes(std::vector<Scene> &list) {
+    char     name[64];
+    uint8_t  i;
+    int16_t  x1, y1;
+    uint16_t w, h;
+
+    for(i=0; i<4; i++) {
+        snprintf(name, sizeof(name), "prims_r%d", i);
+        add(list, name, 128, 64, 1, primitives1, i);
+        snprintf(name, sizeof(name), "prims16_r%d", i);
+        add(list, name, 128, 64, 16, primitives16, i);
+    }
+    for(i=1; i<=4; i++) {
+        snprintf(name, sizeof(name), "text_classic_s%d", i);
+        add(list, name, 128, 64, 1, textClassic, i);
+        snprintf(name, sizeof(name), "text_gfx_s%d", i);
+        add(list, name, 256, 128, 1, textFont, i);
+    }
+    for(i=1; i<4; i++) {
+        w = (i & 1) ? 64 : 128;
+        h = (i & 1) ? 128 : 64;
+        snprintf(name, sizeof(name), "rotate_into_r%d", i);
+        add(list, name, w, h, 1, rotated, i);
+        snprintf(name, sizeof(name), "rotate_into16_r%d", i);
+        add(list, name, w, h, 16, rotated16, i);
+    }
+    for(i=2; i<=4; i++) {
+        snprintf(name, sizeof(name), "scale_into_x%d", i);
+        add(list, name, 64 * i, 16 * i, 1, scaled, i);
+        snprintf(name, sizeof(name), "scale_into16_x%d", i);
+        add(list, name, 48 * i, 24 * i, 16, scaled16, i);
+    }
+    add(list, "opaque", 128, 40, 1, opaqueText, 0);
+    add(list, "dither", 64, 48, 1, dither, 0);
+    for(i=1; i<=2; i++) {
+        snprintf(name, sizeof(name), "qr_v3_m_x%d", i);
+        add(list, name, 37 * i, 37 * i, 1, qrcode, i);
+        snprintf(name, sizeof(name), "qr_v10_l_x%d", i);
+        add(list, name, 65 * i, 65 * i, 1, qrcode, 4 | i);
+    }
+    add(list, "text_layout", 128, 128, 1, textLayout, 0);
+    add(list, "text_layout_w60", 64, 88, 1, textLayout, 1);
+
+    GFXcanvas1 measure(1, 1);
+    measure.setTextWrap(false);
+    for(i=0; i<sizeof(testFonts) / sizeof(testFonts[0]); i++) {
+        measure.setFont(testFonts[i].font);
+        measure.getTextBounds((char *)sample, 0, 0, &x1, &y1, &w, &h);
+        add(list, std::string("font_") + testFonts[i].name, w + 2, h + 2, 1,
+          fontLine, i);
+    }
+
+    uint8_t fonts = sizeof(testFonts) / sizeof(testFonts[0]);
+    rleFonts.assign(fonts, GFXfont());
+    rleBitmaps.assign(fonts, std::vector<uint8_t>());
+    rleGlyphs.assign(fonts, std::vector<GFXglyph>());
+    for(i=0; i<fonts; i++) {
+        rleFont(i);
+        measure.setFont(&rleFonts[i]);
+        measure.getTextBounds((char *)sample, 0, 0, &x1, &y1, &w, &h);
+        add(list, std::string("font_rle_") + testFonts[i].name, w + 2, h + 2,
+          1, fontLineRLE, i);
+    }
+}
@@ -4,6 +4,8 @@
 #include <ESP8266WebServer.h>
 #include <ESP8266mDNS.h>
 #include <Adafruit_SSD1306.h>
+#include <GFXfontFile.h>
+#include <GFXmirror.h>
 #include <NeoPixelBus.h>
 #include <NeoPixelAnimator.h>
 #include <ArduinoOTA.h>
@@ -29,6 +31,7 @@ const char STR_OTA_DONE  [] PROGMEM = "Done. Rebooting...";
 
 const char STR_FILE_WIFI   [] = "/wifi.json";
 const char STR_FILE_CONF   [] = "/conf.json";
+const char STR_DIR_FONTS   [] = "/fonts/";
 const char STR_NAME_DEFAULT[] = "Team 1-1";
 
 const RgbColor COLOR_OFF     (  0,   0,   0);
@@ -39,6 +42,10 @@ const uint16_t  NET_PORT   = 11337;
 const IPAddress NET_SERVER ( 10,  13,  37, 100);
 const IPAddress NET_GROUP  (239,  13,  37,   1);
 
+const uint8_t   NET_CMD_MIRROR = 6;
+const uint8_t   MIRROR_FPS_MAX = 30;
+const ulong     MIRROR_TIMEOUT = 10000; // Stop unless the viewer asks again
+
 // -------------------- CONFIGURATION --------------------
 const uint16_t PixelCount = 8; // make sure to set this to the number of pixels in your strip
 const uint16_t PixelPin = 2;  // make sure to set this to the correct pin, ignored for Esp8266
@@ -73,6 +80,7 @@ enum sigval {
 typedef struct textscroll {
     int16_t length;
     int16_t offset;
+    int16_t baseline;
 } textscroll_t;
 
 const int COLORS_COUNT = 3;
@@ -82,6 +90,7 @@ typedef struct badge {
     RgbColor     color;
     // RgbColor     colors[COLORS_COUNT];
     char         name[256];
+    char         font[32];   // SPIFFS path of the name font, "" if built-in
     textscroll_t scroll;
 } badge_t;
 
@@ -96,10 +105,24 @@ typedef struct flash {
     uint8_t   count;
 } flash_t;
 
+// Where the screen is being mirrored to (see handleMirror)
+typedef struct viewer {
+    IPAddress ip;
+    uint16_t  port;
+    ulong     interval;  // ms between frames, 0 if not mirroring
+    ulong     prev;
+    ulong     requested; // When the viewer last asked for frames
+    uint16_t  seq;
+} viewer_t;
+
 typedef void(*handler_f)(uint8_t cmd);
 
 badge_t badge;
+GFXfontFile nameFont;
+File fontUpload;
 flash_t flash;
+viewer_t viewer;
+GFXmirror mirror;
 
 // ---------- BADGE GLOBALS - CAN BE REMOVED ----------
 
@@ -185,6 +208,32 @@ void runSetupMode() {
 
 // ---------- BADGE FUNCTIONS - CAN BE REMOVED ----------
 
+// Name is drawn in the uploaded font if there is one, else the built-in
+// font at double size.  Switching back to nameFont every frame is cheap:
+// the display only re-measures when loadFont() changes it.
+void selectNameFont() {
+    if(nameFont.getFont()) {
+        oled.setFontSource(&nameFont);
+        oled.setTextSize(1);
+    }
+    else {
+        oled.setFont();
+        oled.setTextSize(2);
+    }
+}
+
+void measureName() {
+    // Update the name rendering length, and put the top of the text
+    // at row 10 whatever the font
+    int16_t ox, oy; uint16_t ow, oh;
+    selectNameFont();
+    oled.getTextBounds(badge.name, 0, 0, &ox, &oy, &ow, &oh);
+    oled.setFont();
+    badge.scroll.length   = -1 * ow;
+    badge.scroll.offset   = SSD1306_LCDWIDTH;
+    badge.scroll.baseline = 10 - oy;
+}
+
 void updateName(const char* name) {
     // Either copy the name or the default name
     strncpy(
@@ -197,12 +246,21 @@ void updateName(const char* name) {
     badge.name[strnlen(name, sizeof(badge.name)-2)  ] = '\n';
     badge.name[strnlen(name, sizeof(badge.name)-2)+1] = '\0';
 
-    // Update the name rendering length
-    int16_t ox, oy; uint16_t ow, oh;
-    oled.setTextSize(2);
-    oled.getTextBounds(badge.name, 0, 0, &ox, &oy, &ow, &oh);
-    badge.scroll.length = -1 * ow;
-    badge.scroll.offset = SSD1306_LCDWIDTH;
+    measureName();
+}
+
+// Load a font file from SPIFFS for the name, or go back to the built-in
+// font if it can't be loaded
+bool loadFont(const char* path) {
+    // nameFont is reloaded in place: have the display forget the bounds
+    // and line extent it measured in the old font
+    oled.setFontSource(NULL);
+    bool ok = (path != NULL) && path[0] && nameFont.begin(SPIFFS, path);
+    if(!ok) nameFont.end();
+    strncpy(badge.font, ok ? path : "", sizeof(badge.font)-1);
+    badge.font[sizeof(badge.font)-1] = '\0';
+    measureName();
+    return ok;
 }
 
 void updateColor(const RgbColor* color, uint8_t count) {
@@ -227,6 +285,7 @@ void saveConfig() {
         strncpy(name, badge.name, size);
         name[size] = '\0';
         root["name"] = name;
+        if(badge.font[0]) root["font"] = badge.font;
 
         size = root.prettyPrintTo(temp, sizeof(temp)-1);
         temp[size] = '\0';
@@ -254,9 +313,10 @@ void renderRSSI() {
 
 void renderName() {
     oled.fillRect(0, 10, 128, 22, BLACK);
-    oled.setTextSize(2);
-    oled.setCursor(badge.scroll.offset, 10);
+    selectNameFont();
+    oled.setCursor(badge.scroll.offset, badge.scroll.baseline);
     oled.print(badge.name);
+    oled.setFont();
     oled.display();
 
     badge.scroll.offset -= 3;
@@ -342,6 +402,72 @@ void runEvents() {
 //     updateColor(&COLOR_ECHO, 2);
 // }
 
+// Screen mirroring: a viewer (tools/mirror.js) sends
+//   NET_CMD_MIRROR, team, id, fps, flags (bit 0: send a keyframe)
+// at least every MIRROR_TIMEOUT ms, fps 0 to stop.  The badge answers
+// with up to 'fps' packets a second, whenever the screen changed:
+//   NET_CMD_MIRROR, team, id, uint16_t seq, width, pages, GFXA frame
+// Frames go back to the address the request came from.  UDP source
+// addresses can be forged, so only requests from the badge's own subnet
+// are taken, and only from the current viewer until it stops or times
+// out; anyone there can still point at most MIRROR_FPS_MAX small packets
+// a second at a neighbour for MIRROR_TIMEOUT.
+void handleMirror(uint8_t cmd) {
+    if(size < 4) return;
+    uint8_t team  = udp.read();
+    uint8_t id    = udp.read();
+    uint8_t fps   = udp.read();
+    uint8_t flags = udp.read();
+    if(team != badge.team || id != badge.id) return;
+
+    IPAddress from = udp.remoteIP();
+    if(((uint32_t)from ^ (uint32_t)WiFi.localIP()) &
+       (uint32_t)WiFi.subnetMask()) return;
+    if(viewer.interval &&
+       ((uint32_t)from != (uint32_t)viewer.ip ||
+        udp.remotePort() != viewer.port)) return;
+
+    if(fps == 0) {
+        viewer.interval = 0;
+        mirror.end();
+        return;
+    }
+    if(!viewer.interval &&
+       !mirror.begin(oled.width(), (oled.height() + 7) / 8)) return;
+    if(flags & 1) mirror.reset();
+    viewer.ip        = udp.remoteIP();
+    viewer.port      = udp.remotePort();
+    viewer.interval  = 1000 / min(fps, MIRROR_FPS_MAX);
+    viewer.requested = millis();
+}
+
+void runMirror() {
+    if(!viewer.interval) return;
+    ulong curr = millis();
+    if((curr - viewer.requested) >= MIRROR_TIMEOUT) {
+        viewer.interval = 0;
+        mirror.end();
+        return;
+    }
+    if((curr - viewer.prev) < viewer.interval) return;
+
+    // Only what changed since the last packet is sent
+    const uint8_t* buf = oled.getBuffer();
+    if(!mirror.frameSize(buf)) return;
+    viewer.prev = curr;
+    udp.beginPacket(viewer.ip, viewer.port);
+    udp.write(NET_CMD_MIRROR);
+    udp.write(badge.team);
+    udp.write(badge.id);
+    udp.write(viewer.seq & 0xFF);
+    udp.write(viewer.seq >> 8);
+    udp.write(oled.width());
+    udp.write((oled.height() + 7) / 8);
+    mirror.writeFrame(buf, &udp);
+    udp.endPacket();
+    viewer.seq++;
+}
+
 handler_f handler[] = {
 //     handleTeamChange,
 //     handleColorChange,
@@ -354,7 +480,8 @@ void handleRequests() {
     if(udp.parsePacket() > 0) {
         if((size = udp.available()) > 0) {
             uint8_t cmd = udp.read(); size--;
-            if(cmd > 0 && cmd < 6) handler[cmd-1](cmd);
+            if(cmd == NET_CMD_MIRROR) handleMirror(cmd);
+            else if(cmd > 0 && cmd < 6) handler[cmd-1](cmd);
         }
         udp.flush();
     }
@@ -471,6 +598,61 @@ void route_v1_setWiFiAP() {
 
 }
 
+// Where an uploaded font is stored, or "" if its name won't do.  SPIFFS
+// paths are at most 31 characters, and there are no subdirectories.
+String fontUploadPath() {
+  String name = web.upload().filename;
+  if(name.length() == 0 || name.indexOf('/') >= 0 ||
+     strlen(STR_DIR_FONTS) + name.length() > 31) return String();
+  return String(STR_DIR_FONTS) + name;
+}
+
+// Font upload: multipart POST of a file made by 'fontconvert -b'.
+// It's stored in STR_DIR_FONTS and used for the name from then on.
+void route_v1_fontUpload() {
+  HTTPUpload& upload = web.upload();
+
+  if(upload.status == UPLOAD_FILE_START) {
+    String path = fontUploadPath();
+    if(path.length() == 0) return;
+    // Replacing the font in use: let go of it first
+    if(path == badge.font) loadFont(NULL);
+    fontUpload = SPIFFS.open(path, "w");
+  }
+  else if(upload.status == UPLOAD_FILE_WRITE) {
+    if(fontUpload) fontUpload.write(upload.buf, upload.currentSize);
+  }
+  else if(upload.status == UPLOAD_FILE_END) {
+    if(fontUpload) fontUpload.close();
+  }
+}
+
+void route_v1_font() {
+  StaticJsonBuffer<JSON_BUFF_SIZE> buff;
+  JsonObject& root = buff.createObject();
+  String path = fontUploadPath();
+  // Check the upload with a minimal cache before loadFont(), so that a
+  // bad file doesn't cost the font in use
+  GFXfontFile check;
+  bool valid = path.length() && check.begin(SPIFFS, path.c_str(), 0);
+  check.end();
+
+  if(valid && loadFont(path.c_str())) {
+    saveConfig();
+    root["status"] = "OK";
+    root["data"] = badge.font;
+  }
+  else {
+    if(path.length()) SPIFFS.remove(path);
+    root["status"] = "Error";
+    root["error"] = "Invalid font file";
+  }
+
+  size = root.prettyPrintTo(temp, sizeof(temp)-1);
+  temp[size] = '\0';
+  web.send(200, "application/json", temp);
+}
+
 void setupModeWeb() {
   if (MDNS.begin("esp8266")) {
     Serial.println("MDNS responder started");
@@ -494,6 +676,7 @@ void setupProductionWeb() {
   web.on("/", route_allo);
   web.on("/api/v1/setup/isSetupMode", HTTP_GET, route_v1_isSetupMode);
   // web.on("/api/v1/setup/setWiFiAP", HTTPMethod::HTTP_POST, route_v1_setWiFiAP);
+  web.on("/api/v1/font", HTTP_POST, route_v1_font, route_v1_fontUpload);
 
   web.onNotFound(route_notFound);
 
@@ -545,6 +728,7 @@ void setup() {
     badge.team  = BADGE_TEAM_DEFAULT;
     badge.id    = BADGE_ID_DEFAULT;
     badge.color = COLOR_DEFAULT;
+    badge.font[0] = '\0';
     updateName(STR_NAME_DEFAULT);
 
     // Load the badge configuration file
@@ -577,6 +761,9 @@ void setup() {
                 // Parse the badge name
                 const char* name = root["name"];
                 updateName(name);
+
+                // Use the uploaded name font, if any
+                loadFont(root["font"]);
             }
             else {
                 enableSetupMode("Badge conf invalid");
@@ -710,6 +897,9 @@ void loop() {
     // Handle incoming UDP requests
     handleRequests();
 
+    // Send the screen to a viewer, if there is one
+    runMirror();
+
     // ---------- USER CODE GOES HERE ----------
 
     // Setup should only handle OTA requests
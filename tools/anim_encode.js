@@ -0,0 +1,153 @@
+'use strict';
+// Encodes binary PBM ('P4') frames into a GFXanimation ('GFXA', see
+// lib/Adafruit-GFX-Library-master/GFXanimation.h) for the OLED. Light
+// (0) PBM pixels are lit. Frames of a GIF can be split with e.g.
+//   convert anim.gif -coalesce -threshold 50% frame%03d.pbm
+// The first frame is a keyframe; the others are XOR deltas of the runs
+// of page bytes that changed, or keyframes where that is no smaller.
+// Writes a C header to stdout (or the raw bytes with -b) and statistics
+// to stderr.
+const fs   = require('fs');
+const path = require('path');
+
+const RUN_GAP   = 3; // Unchanged bytes bridged rather than starting a run
+const CMD_BYTES = 6; // SSD1306 column + page address commands per window
+
+function usage () {
+  console.error('Usage: node anim_encode.js [-d MS] [-k N] [-n NAME] [-b] FRAME.pbm...');
+  console.error('  -d  display time of each frame in ms (default 100)');
+  console.error('  -k  also make every Nth frame a keyframe');
+  console.error('  -n  array name (default from the first file)');
+  console.error('  -b  write binary instead of a C header');
+  process.exit(1);
+}
+
+// Returns {width, height, pages, data}, data page-major with LSB on top
+function readPBM (file) {
+  const buf = fs.readFileSync(file);
+  let pos = 2;
+  function number () {
+    for(;;) {
+      const c = buf[pos];
+      if(c === 0x23) while(pos < buf.length && buf[pos] !== 0x0A) pos++;
+      else if(c === 0x20 || c === 0x09 || c === 0x0A || c === 0x0D) pos++;
+      else break;
+    }
+    const start = pos;
+    while(buf[pos] >= 0x30 && buf[pos] <= 0x39) pos++;
+    return parseInt(buf.toString('ascii', start, pos++));
+  }
+  if(buf.toString('ascii', 0, 2) !== 'P4') throw new Error(file + ': not a binary PBM');
+  const width  = number();
+  const height = number();
+  const stride = (width + 7) >> 3;
+  if(!(width > 0 && width < 256 && height > 0 && height <= 64)) {
+    throw new Error(file + ': ' + width + 'x' + height + ' is too big');
+  }
+  if(buf.length < pos + stride * height) throw new Error(file + ': truncated');
+  const pages = (height + 7) >> 3;
+  const data  = Buffer.alloc(width * pages);
+  for(let y = 0; y < height; y++) {
+    for(let x = 0; x < width; x++) {
+      if(!(buf[pos + y * stride + (x >> 3)] & (0x80 >> (x & 7)))) {
+        data[(y >> 3) * width + x] |= 1 << (y & 7);
+      }
+    }
+  }
+  return { width: width, height: height, pages: pages, data: data };
+}
+
+// Runs of changed bytes between two buffers, as [page, column, bytes]
+function deltaRuns (prev, cur, width, pages) {
+  const runs = [];
+  for(let p = 0; p < pages; p++) {
+    let x = 0;
+    while(x < width) {
+      const i = p * width;
+      if(prev[i + x] === cur[i + x]) { x++; continue; }
+      let end = x + 1, last = x;
+      while(end < width && end - x < 255 && end - last <= RUN_GAP) {
+        if(prev[i + end] !== cur[i + end]) last = end;
+        end++;
+      }
+      const bytes = Buffer.alloc(last - x + 1);
+      for(let k = x; k <= last; k++) bytes[k - x] = prev[i + k] ^ cur[i + k];
+      runs.push([p, x, bytes]);
+      x = last + 1;
+    }
+  }
+  return runs;
+}
+
+let frameMs = 100, keyEvery = 0, name = null, binary = false;
+const files = [];
+const argv  = process.argv.slice(2);
+for(let i = 0; i < argv.length; i++) {
+  switch(argv[i]) {
+    case '-d': frameMs  = parseInt(argv[++i]); break;
+    case '-k': keyEvery = parseInt(argv[++i]); break;
+    case '-n': name     = argv[++i]; break;
+    case '-b': binary   = true; break;
+    default:   files.push(argv[i]);
+  }
+}
+if(!files.length || !(frameMs >= 0 && frameMs < 65536) || files.length > 65535) usage();
+if(!name) name = path.basename(files[0]).replace(/\d*\.pbm$/i, '').replace(/\W/g, '_') + 'Anim';
+
+const frames = files.map(readPBM);
+const width  = frames[0].width;
+const pages  = frames[0].pages;
+frames.forEach(function (f, i) {
+  if(f.width !== width || f.pages !== pages) {
+    throw new Error(files[i] + ': not the same size as ' + files[0]);
+  }
+});
+
+const out = [Buffer.from([
+  0x47, 0x46, 0x58, 0x41, 1, width, pages, 0,
+  frames.length & 0xFF, frames.length >> 8, frameMs & 0xFF, frameMs >> 8
+])];
+const frameBytes = width * pages;
+let   keys = 0, busTotal = 0, busMax = 0;
+frames.forEach(function (f, i) {
+  const runs = i ? deltaRuns(frames[i - 1].data, f.data, width, pages) : null;
+  const size = runs ? runs.reduce(function (n, r) { return n + 3 + r[2].length; }, 2) : 0;
+  let   bus  = 0;
+  if(!runs || (keyEvery && !(i % keyEvery)) || size >= 1 + frameBytes) {
+    out.push(Buffer.from([0]), f.data);
+    bus = frameBytes + CMD_BYTES;
+    keys++;
+  } else {
+    const x0 = [], x1 = [];
+    out.push(Buffer.from([1]));
+    runs.forEach(function (r) {
+      out.push(Buffer.from([r[0], r[1], r[2].length]), r[2]);
+      x0[r[0]] = Math.min(r[1], x0[r[0]] === undefined ? 255 : x0[r[0]]);
+      x1[r[0]] = Math.max(r[1] + r[2].length - 1, x1[r[0]] || 0);
+    });
+    out.push(Buffer.from([0xFF]));
+    x0.forEach(function (x, p) { bus += x1[p] - x + 1 + CMD_BYTES; });
+    bus = Math.min(bus, frameBytes + CMD_BYTES); // Else push the lot
+  }
+  busTotal += bus;
+  busMax    = Math.max(busMax, bus);
+});
+const anim = Buffer.concat(out);
+
+if(binary) {
+  process.stdout.write(anim);
+} else {
+  let s = 'const uint8_t ' + name + '[] PROGMEM = {\n  ';
+  for(let i = 0; i < anim.length; i++) {
+    if(i) s += (i % 12) ? ', ' : ',\n  ';
+    s += '0x' + ('0' + anim[i].toString(16).toUpperCase()).slice(-2);
+  }
+  s += ' };\n\n// Approx. ' + anim.length + ' bytes\n';
+  process.stdout.write(s);
+}
+
+const raw = frames.length * frameBytes;
+console.error(frames.length + ' frames (' + keys + ' key), ' + width + 'x' + pages * 8 +
+  ': ' + anim.length + ' bytes vs ' + raw + ' raw, ratio ' + (raw / anim.length).toFixed(1) + ':1');
+console.error('bus bytes per frame: average ' + (busTotal / frames.length).toFixed(0) +
+  ', max ' + busMax + ', full display() ' + (frameBytes + CMD_BYTES));
@@ -15,6 +15,7 @@ module.exports = {
     color: 2,
     teamcolor: 3,
     name: 4,
-    echo: 5
+    echo: 5,
+    mirror: 6
   }
 };
\ No newline at end of file
@@ -0,0 +1,174 @@
+'use strict';
+// Shows what a badge's OLED is displaying: asks the badge to mirror its
+// screen (handleMirror in src/main.cpp) and rebuilds each frame from the
+// keyframes and XOR deltas it sends, the same frames as a GFXA animation
+// (see anim_encode.js).  Every frame is written to DIR/screen.pbm, or
+// .png with -p; -k keeps them all as DIR/screen00000.pbm etc. instead.
+const dgram  = require('dgram');
+const fs     = require('fs');
+const path   = require('path');
+const zlib   = require('zlib');
+const config = require('./config');
+
+const HEADER    = 7;    // cmd, team, id, seq (2), width, pages
+const RENEW     = 3000; // ms between requests; the badge stops after 10 s
+const FLAG_KEY  = 1;    // Ask for a keyframe
+const KEY_RETRY = 1000; // ms before asking for a keyframe again
+
+function usage () {
+  console.error('Usage: node mirror.js [-f FPS] [-a ADDRESS] [-o DIR] [-p] [-k] TEAM ID');
+  console.error('  -f  frames per second at most (default 10, badge limit 30)');
+  console.error('  -a  badge address (default the multicast group)');
+  console.error('  -o  output directory (default .)');
+  console.error('  -p  write PNG instead of PBM');
+  console.error('  -k  keep every frame rather than overwriting one file');
+  process.exit(1);
+}
+
+let fps = 10, address = config.address.multicast, dir = '.', png = false, keep = false;
+const args = [];
+const argv = process.argv.slice(2);
+for(let i = 0; i < argv.length; i++) {
+  switch(argv[i]) {
+    case '-f': fps     = parseInt(argv[++i]); break;
+    case '-a': address = argv[++i]; break;
+    case '-o': dir     = argv[++i]; break;
+    case '-p': png     = true; break;
+    case '-k': keep    = true; break;
+    default:   args.push(parseInt(argv[i]));
+  }
+}
+const team = args[0], id = args[1];
+if(args.length !== 2 || !(team >= 1 && team <= 255) || !(id >= 1 && id <= 255) ||
+   !(fps >= 1 && fps <= 255)) usage();
+
+// Page-major screen (LSB on top), null until the first keyframe
+let screen = null, width = 0, pages = 0, nextSeq = -1, needKey = true;
+let frames = 0, packets = 0, bytes = 0, keys = 0, keyAsked = 0;
+
+const CRC_TABLE = [];
+for(let n = 0; n < 256; n++) {
+  let c = n;
+  for(let k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320 ^ (c >>> 1) : c >>> 1;
+  CRC_TABLE[n] = c >>> 0;
+}
+function crc32 (buf) {
+  let c = 0xFFFFFFFF;
+  for(let i = 0; i < buf.length; i++) c = CRC_TABLE[(c ^ buf[i]) & 0xFF] ^ (c >>> 8);
+  return (c ^ 0xFFFFFFFF) >>> 0;
+}
+function chunk (type, data) {
+  const len = Buffer.alloc(4), crc = Buffer.alloc(4), body = Buffer.concat([Buffer.from(type), data]);
+  len.writeUInt32BE(data.length);
+  crc.writeUInt32BE(crc32(body));
+  return Buffer.concat([len, body, crc]);
+}
+
+// Screen as 1-bit rows, MSB first, lit pixels set
+function rows () {
+  const height = pages * 8, stride = (width + 7) >> 3;
+  const out = Buffer.alloc(stride * height);
+  for(let y = 0; y < height; y++) {
+    for(let x = 0; x < width; x++) {
+      if(screen[(y >> 3) * width + x] & (1 << (y & 7))) out[y * stride + (x >> 3)] |= 0x80 >> (x & 7);
+    }
+  }
+  return out;
+}
+
+function encodePBM () {
+  const bits = rows();
+  for(let i = 0; i < bits.length; i++) bits[i] ^= 0xFF; // PBM 1 is black
+  return Buffer.concat([Buffer.from('P4\n' + width + ' ' + pages * 8 + '\n'), bits]);
+}
+
+function encodePNG () {
+  const bits = rows(), stride = (width + 7) >> 3, height = pages * 8;
+  const raw  = Buffer.alloc((stride + 1) * height); // Filter byte 0 per row
+  for(let y = 0; y < height; y++) bits.copy(raw, y * (stride + 1) + 1, y * stride, (y + 1) * stride);
+  const ihdr = Buffer.alloc(13);
+  ihdr.writeUInt32BE(width, 0);
+  ihdr.writeUInt32BE(height, 4);
+  ihdr[8] = 1; // 1-bit grayscale
+  return Buffer.concat([
+    Buffer.from([0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A]),
+    chunk('IHDR', ihdr), chunk('IDAT', zlib.deflateSync(raw)), chunk('IEND', Buffer.alloc(0))
+  ]);
+}
+
+function writeFrame () {
+  const name = 'screen' + (keep ? ('0000' + frames).slice(-5) : '') + (png ? '.png' : '.pbm');
+  fs.writeFileSync(path.join(dir, name), png ? encodePNG() : encodePBM());
+  frames++;
+}
+
+// Applies one GFXA frame; false if it's malformed or can't be applied
+function applyFrame (msg, pos) {
+  const type = msg[pos++];
+  if(type === 0) {
+    if(msg.length - pos !== width * pages) return false;
+    msg.copy(screen, 0, pos);
+    keys++;
+    return true;
+  }
+  if(type !== 1 || needKey) return false;
+  for(;;) {
+    if(pos >= msg.length) return false;
+    const p = msg[pos++];
+    if(p === 0xFF) return pos === msg.length;
+    const x = msg[pos], n = msg[pos + 1];
+    pos += 2;
+    if(p >= pages || !n || x + n > width || pos + n > msg.length) return false;
+    for(let i = 0; i < n; i++) screen[p * width + x + i] ^= msg[pos++];
+  }
+}
+
+const socket = dgram.createSocket('udp4');
+
+function request (rate) {
+  const cmd = Buffer.from([config.commands.mirror, team, id, rate, needKey ? FLAG_KEY : 0]);
+  socket.send(cmd, 0, cmd.length, config.port, address, function (err) {
+    if(err) console.error('request error: ', err);
+  });
+}
+
+socket.on('message', function (msg) {
+  if(msg.length <= HEADER || msg[0] !== config.commands.mirror || msg[1] !== team || msg[2] !== id) return;
+  const seq = msg.readUInt16LE(3);
+  packets++;
+  bytes += msg.length;
+  if(!screen || msg[5] !== width || msg[6] !== pages) {
+    width  = msg[5];
+    pages  = msg[6];
+    screen = Buffer.alloc(width * pages);
+    needKey = true;
+  }
+  // A lost packet leaves the screen wrong until the next keyframe
+  if(seq !== nextSeq) needKey = true;
+  nextSeq = (seq + 1) & 0xFFFF;
+  if(applyFrame(msg, HEADER)) {
+    needKey = false;
+    writeFrame();
+  } else {
+    needKey = true;
+    if(Date.now() - keyAsked >= KEY_RETRY) {
+      keyAsked = Date.now();
+      request(fps);
+    }
+  }
+});
+
+socket.on('listening', function () {
+  console.error('mirroring badge ' + team + '-' + id + ' via ' + address + ':' + config.port);
+  request(fps);
+  setInterval(function () { request(fps); }, RENEW);
+});
+
+process.on('SIGINT', function () {
+  request(0);
+  console.error(frames + ' frames (' + keys + ' key) in ' + packets + ' packets, ' + bytes +
+    ' bytes, average ' + (packets ? (bytes / packets).toFixed(0) : 0) + ' per packet');
+  setTimeout(function () { process.exit(0); }, 100);
+});
+
+socket.bind();